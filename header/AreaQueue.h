@@ -0,0 +1,65 @@
+#pragma once
+// File: AreaQueue.h
+//
+// Contains the class definition for the AreaQueue, the priority queue of
+// service areas used by price priority scheduling (see PowerGrid::distributePower).
+//
+// The queue holds the areas that still need power, highest priority first.
+// An area with a higher MW price comes first; between areas with the same
+// price, the one with the larger deficit comes first, then the one earlier
+// in the file.
+//
+// The queue is an indexed binary heap: it knows where each area is in the
+// heap, so when addCapacity changes the deficit of an area its entry is
+// moved up or down in O(log n) instead of sorting the areas again.  An
+// area that is fully supplied drops out of the queue and comes back when
+// its deficit grows again (e.g. resetPower).
+//
+// During a distribution pass each area is served at most once: pop() takes
+// the top area out and holds it until release() is called at the end of the
+// pass, when it goes back into the queue if it still needs power.
+//
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+class AreaQueue {
+private:
+    enum EntryState : unsigned char { OUT, IN_HEAP, HELD };
+
+    vector<double>      price;          // Key of each area (by area index)
+    vector<double>      deficit;
+    vector<size_t>      heapPos;        // Position of each area in the heap
+    vector<EntryState>  state;
+    vector<size_t>      heap;           // Area indexes, heap[0] is the top
+    double              minDeficit = 0.0;   // Areas with this deficit or less do not need power
+
+    bool before(size_t a, size_t b) const;     // True if area a has a higher priority than b
+    void place(size_t pos, size_t area);
+    void siftUp(size_t pos);
+    void siftDown(size_t pos);
+    void push(size_t area);
+    void remove(size_t area);
+
+public:
+    static const size_t NO_AREA = size_t(-1);
+
+    AreaQueue() = default;
+
+    // Rebuild the queue.  The areas with a deficit above minDeficit are added.
+    void build(const vector<double>& areaPrices, const vector<double>& areaDeficits, double minDeficit);
+    void clear();
+
+    // Called when the deficit of an area changes
+    void update(size_t area, double newDeficit);
+
+    // Take the highest priority area out of the queue and hold it (NO_AREA if empty)
+    size_t pop();
+
+    // Put a held area back if it still needs power
+    void release(size_t area);
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+};
@@ -0,0 +1,63 @@
+#pragma once
+// File: CapacityIndex.h
+//
+// Contains the class definition for the CapacityIndex, an index over the
+// remaining capacity of a set of slots (transmission lines or plants).
+//
+// The distribution functions need "the first line (or plant) that still has
+// at least X MW".  Scanning the vector for every request is O(n) per request.
+// The index keeps a max segment tree over the slots in order: each node
+// holds the largest capacity in its range, so the leftmost slot with a
+// capacity of at least X is found by walking down from the root in
+// O(log n), and changing the capacity of one slot is also O(log n).
+//
+// For the best-fit search (the slot with the smallest capacity that still
+// covers X) the index can also keep an ordered set of (capacity, slot)
+// pairs.  It is only kept when best-fit is turned on, since it costs a
+// tree insert and erase for every update.
+//
+// The owner of the index calls update() every time the capacity of a slot
+// changes (see TransmissionLine::reduceCapacity).
+//
+#include <vector>
+#include <set>
+#include <utility>
+#include <cstddef>
+
+using namespace std;
+
+class CapacityIndex {
+private:
+    size_t                      slotCount = 0;  // Number of slots in use
+    size_t                      leafCount = 0;  // Slots rounded up to a power of 2
+    vector<double>              tree;           // tree[1] is the root, leaves start at leafCount
+    bool                        bestFitEnabled = false;
+    set<pair<double, size_t>>   bySize;         // (capacity, slot) - only for best-fit
+
+public:
+    static const size_t NO_SLOT = size_t(-1);  // Returned when no slot has the capacity
+
+    CapacityIndex() = default;
+
+    // Rebuild the index with the capacity of each slot
+    void build(const vector<double>& capacities);
+    void clear();
+
+    // Keep the ordered set needed by bestFit() (rebuilds it from the tree)
+    void enableBestFit(bool enable);
+    bool isBestFitEnabled() const { return bestFitEnabled; }
+
+    // Change the capacity of one slot
+    void update(size_t slot, double capacity);
+
+    // Leftmost slot with a capacity >= amount, or NO_SLOT
+    size_t firstAtLeast(double amount) const;
+
+    // Slot with the smallest capacity >= amount (leftmost on a tie), or NO_SLOT.
+    // Uses the ordered set when best-fit is enabled, or scans the slots otherwise.
+    size_t bestFit(double amount) const;
+
+    double getCapacity(size_t slot) const { return tree[leafCount + slot]; }
+    double getMaxCapacity() const { return slotCount == 0 ? 0.0 : tree[1]; }
+    size_t size() const { return slotCount; }
+};
@@ -0,0 +1,57 @@
+#pragma once
+// File: ContingencyAnalysis.h
+//
+// Contains the class definitions for the N-1 contingency analysis.
+//
+// Each contingency takes one asset out of service (a plant goes offline, or
+// a transmission line is derated to 0) and runs the same distribution as
+// main() (60% then 10% four times).  The percent of demand met (as in
+// generateUsageReport) is compared with the base case, where every asset is
+// in service, and the outages are ranked by how much they lower it.
+//
+// The contingencies run in parallel on a WorkStealingPool.  Each worker has
+// its own copy-on-write branch of the rated grid (see GridBranch.cpp), and
+// restores it before each contingency (see GridState.cpp), so the data files
+// are read once and only the plants that are taken offline are copied.
+//
+#include <vector>
+#include "PowerGrid.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+// The kind of asset taken out of service
+enum AssetType {
+    ASSET_PLANT,
+    ASSET_LINE
+};
+
+struct ContingencyResult {
+    AssetType   type;
+    size_t      index;          // Position in getPlants() or getTransmissionLines()
+    double      percentMet;     // Percent of demand met with the asset out of service
+    double      drop;           // Base case percent met - percentMet
+};
+
+struct ContingencyResults {
+    double                      basePercentMet = 0.0;
+    vector<ContingencyResult>   outages;        // Largest drop first
+    double                      seconds = 0.0;  // Time used to run all of the contingencies
+};
+
+
+class ContingencyAnalysis {
+private:
+    const PowerGrid&    grid;       // Rated grid the contingencies branch from
+    WorkStealingPool&   pool;
+
+    static double percentMet(const PowerGrid& scenarioGrid);
+    static double runContingency(PowerGrid& scenarioGrid, const ContingencyResult* pOutage);
+
+public:
+    // The grid must be rated (adjustPlantsForConditions) and must not change
+    // while the analysis runs
+    ContingencyAnalysis(const PowerGrid& ratedGrid, WorkStealingPool& workers) : grid(ratedGrid), pool(workers) {}
+
+    ContingencyResults run();
+};
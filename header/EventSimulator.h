@@ -0,0 +1,124 @@
+#pragma once
+// File: EventSimulator.h
+//
+// Contains the class definition for the discrete event simulation of
+// outages and recoveries on a dispatched grid.
+//
+// Events are kept in a priority queue by time (hours).  Each event changes
+// one plant, line, or area and moves only the power that change affects:
+//      trip      plant goes offline       releases and moves its allocations
+//      restore   plant comes back online  fills the areas events left short
+//      rods      fuel rods of a nuclear   moves its allocations
+//      derate    line limited to value    moves the power over the new limit
+//                (0 to 1 of its capacity)
+//      demand    area demand set to value gives back extra power or requests more
+// The areas an event moves power from are remembered while they are short.
+// When an event gives capacity back (a restore, more rods, a higher line
+// limit, or less demand) those areas request what they are short.  Areas no
+// event has touched keep the power of the first dispatch.
+// An event with a duration holds its plant, line, or area at its value and
+// schedules the end of the hold that many hours later.  Holds on the same
+// thing may overlap: the latest one that has not ended sets the value, and
+// when the last one ends the value goes back to what it was before them (a
+// tripped plant comes back only when its last outage ends).  An event
+// without a duration sets the value for good and drops the holds on it.
+// An event that would not change the grid (a trip of a plant that is
+// already offline) is skipped, and no undo is scheduled for it.  Between
+// events the grid does not change, so the energy required and served is
+// added up once for each event.
+//
+// The event file is comma separated, one event on each line:
+//      time, event, plant/line/area name, value, duration
+// Lines starting with # are comments.  Events at the same time run in the
+// order they were scheduled.
+//
+#include <string>
+#include <vector>
+#include <queue>
+#include <map>
+#include <utility>
+#include <ostream>
+#include "GridDef.h"
+#include "PowerGrid.h"
+
+using namespace std;
+
+enum GridEventType {
+    EVENT_PLANT_TRIP,
+    EVENT_PLANT_RESTORE,
+    EVENT_FUEL_RODS,
+    EVENT_LINE_DERATE,
+    EVENT_DEMAND
+};
+
+struct GridEvent {
+    double          time = 0.0;         // Hours from the start of the simulation
+    GridEventType   type = EVENT_PLANT_TRIP;
+    size_t          index = 0;          // Position in getPlants(), getTransmissionLines(), or getAreas()
+    double          value = 0.0;        // Fuel rods, line fraction, or area demand (MW)
+    double          duration = 0.0;     // Hours until the event is undone (0 = never)
+};
+
+// Totals over the simulated time
+struct EventStats {
+    size_t  events = 0;
+    double  hours = 0.0;
+    double  energyRequired = 0.0;       // MWh
+    double  energyServed = 0.0;         // MWh
+    double  lowestPercentMet = 100.0;
+    double  lowestTime = 0.0;           // When the lowest percent met started
+};
+
+
+class EventSimulator {
+private:
+    PowerGrid&  grid;
+
+    static constexpr size_t NOT_AN_UNDO = SIZE_MAX;
+    struct QueuedEvent {
+        GridEvent   event;
+        size_t      sequence;           // Keeps events at the same time in order
+        size_t      undoOf;             // Sequence of the event whose hold this ends (or NOT_AN_UNDO)
+    };
+    struct LaterEvent {
+        bool operator()(const QueuedEvent& a, const QueuedEvent& b) const {
+            return a.event.time > b.event.time || (a.event.time == b.event.time && a.sequence > b.sequence);
+        }
+    };
+    priority_queue<QueuedEvent, vector<QueuedEvent>, LaterEvent> eventQueue;
+    size_t      nextSequence = 0;
+    double      clock = 0.0;
+    vector<size_t> shortAreas;          // Areas events have left short of power
+
+    // The plants, lines, and areas held by events with a duration, by the
+    // type of event (trips and restores use EVENT_PLANT_TRIP) and index.
+    // The value before the holds is kept to go back to when they all end.
+    using HeldKey = pair<GridEventType, size_t>;
+    struct Held {
+        double                          before;
+        vector<pair<size_t, double>>    holds;  // Sequence and value of each event, oldest first
+    };
+    map<HeldKey, Held> heldValues;
+    EventStats  stats;
+
+    void advanceTo(double time);
+    bool applyEvent(QueuedEvent& queued);
+    double currentValue(const HeldKey& key) const;
+    double percentMet() const;
+
+public:
+    // The grid must be rated and dispatched before the simulation starts
+    explicit EventSimulator(PowerGrid& simGrid) : grid(simGrid) {}
+
+    void schedule(const GridEvent& event);
+    int  readEvents(const string& filename = EVENTS_FILENAME);   // Returns 0 on success
+
+    // Runs the events up to endTime and adds up the energy to endTime.  Each
+    // event that changed the grid is written to the log (if any) as a comma
+    // separated line.  Returns the number of events that changed the grid.
+    size_t run(double endTime, ostream* pLog = nullptr);
+
+    double getClock() const { return clock; }
+    size_t getPendingCount() const { return eventQueue.size(); }
+    const EventStats& getStats() const { return stats; }
+};
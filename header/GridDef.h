@@ -18,6 +18,18 @@ const string PLANTS_FILENAME     = "../data/A2_Plants.txt";
 const string TRANSLINES_FILENAME = "../data/A2_TransLines.txt";
 const string REPORT_FILENAME     = "../data/A2_Report.txt";
 
+// Precompiled binary image of the three data files (built by tools/MakeGridImage.cpp).
+// When it exists and is newer than the text files it is loaded instead of them.
+const string GRID_IMAGE_FILENAME = "../data/A2_Grid.img";
+
+// Per interval plant conditions and area demand, and the results of each
+// interval, for the time-stepped simulation (see TimeSeries.h)
+const string TIMESERIES_FILENAME         = "../data/A2_TimeSeries.csv";
+const string TIMESERIES_RESULTS_FILENAME = "../data/A2_TimeSeriesResults.csv";
+
+// Timed outage and recovery events for the event simulation (see EventSimulator.h)
+const string EVENTS_FILENAME = "../data/A2_Events.csv";
+
 // Plant type identifiers (used when reading data files)
 const string PT_SOLAR       = "Solar";
 const string PT_WIND        = "Wind";
@@ -32,11 +44,21 @@ const string FILE_HEADER_DELIMITER = "&*****&";
 // Transmission line constants
 const int MAX_LINE_CONNECTIONS = 4;   // Maximum connections per line
 
+// Most (plant, line) pairs used to fill one request when allocations are split
+const int MAX_ALLOC_FRAGMENTS = 8;
+
 // Environmental / plant-specific limits
 const double MAX_SUNLIGHT_HOURS = 12.0;  // Maximum possible sunlight hours per day
 const double MAX_WIND_SPEED      = 25.0; // Maximum wind speed used for output calculations
 const int    MAX_FUEL_RODS       = 100;  // Maximum fuel rods for nuclear plants
 
+// Unit commitment (see UnitCommitment.h): the most a gas throttle or the fuel
+// rods of a nuclear plant can change from one period to the next, and the
+// throttle steps that are scheduled
+const double GAS_RAMP_PERCENT      = 20.0;  // Throttle % per period
+const int    NUCLEAR_RAMP_RODS     = 4;     // Fuel rods per period
+const double THROTTLE_STEP_PERCENT = 5.0;
+
 // Optional: default values for new simulation features
 const double DEFAULT_EFFICIENCY  = 95.0; // Default efficiency for transmission lines (%)
 const double DEFAULT_THROTTLE    = 100.0; // Default throttle % for gas plants
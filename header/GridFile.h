@@ -0,0 +1,98 @@
+#pragma once
+// File: GridFile.h
+//
+// Contains class definitions used to read the grid data files quickly.
+//
+// MappedFile maps a whole data file into memory (read only) so it can be
+// parsed in place without copying it into stream buffers.
+//
+// TextScanner walks a block of text (normally the mapped file) and hands
+// back string_views that point directly into that text.  Numbers are
+// converted with a locale free parser (std::from_chars).
+//
+// Note: A string_view returned by the scanner is only valid while the
+//       MappedFile that owns the text is still open.
+//
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+using namespace std;
+
+//
+// Class MappedFile
+//
+// Maps a file into the address space of the process.  The mapping is
+// released when the object is closed or destroyed.
+//
+class MappedFile {
+private:
+    const char* pData = nullptr;    // Start of the mapped text
+    size_t      size = 0;           // Number of bytes mapped
+    bool        opened = false;     // True once open() succeeds (even for an empty file)
+
+#ifdef _WIN32
+    void*       hFile = nullptr;    // Windows file and mapping handles
+    void*       hMapping = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    // A mapping can not be shared between two objects
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const string& filename);  // Returns false if file can not be mapped
+    void close();
+
+    string_view view() const { return string_view(pData, size); }
+    bool isOpen() const { return opened; }
+};
+
+
+//
+// Class TextScanner
+//
+// Tokenizes text in place.  Tokens are separated by whitespace, and the
+// scanner keeps track of the current position in the text.
+//
+class TextScanner {
+private:
+    string_view text;       // All of the text being scanned
+    size_t      pos = 0;    // Current position in the text
+
+public:
+    explicit TextScanner(string_view txt) : text(txt) {}
+
+    bool atEnd() const { return pos >= text.size(); }
+
+    // Skip spaces, tabs, and line breaks
+    void skipWhitespace();
+
+    // Return the rest of the current line (without the line break)
+    string_view nextLine();
+
+    // Skip lines until a line matching the delimiter has been read
+    bool skipPastLine(string_view delimiter);
+
+    // Return the next whitespace separated token (empty at end of text)
+    string_view nextToken();
+
+    // Return the text up to (not including) the delimiter and skip the delimiter
+    bool readUntil(char delimiter, string_view& field);
+
+    // Return the text of a line up to the next delimiter (or the end of the
+    // line) without the blanks around it, and remove it from the line.
+    // Used for comma separated files.
+    static string_view splitField(string_view& line, char delimiter);
+
+    // Read the next token as a number.  Returns false if it is not a number.
+    bool nextDouble(double& value);
+    bool nextInt(int& value);
+
+    // Locale free conversion of a complete token to a number
+    static bool parseDouble(string_view token, double& value);
+    static bool parseInt(string_view token, int& value);
+};
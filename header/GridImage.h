@@ -0,0 +1,98 @@
+#pragma once
+// File: GridImage.h
+//
+// Contains the layout of the precompiled binary "grid image" file.
+//
+// The grid image is a snapshot of an initialized PowerGrid (before any
+// plant conditions are applied or power is distributed).  It lets the
+// program start without parsing the three text data files.
+//
+// File layout (all values in the byte order of the machine that wrote it):
+//
+//      GridImageHeader
+//      AreaRecord  [areaCount]
+//      PlantRecord [plantCount]
+//      LineRecord  [lineCount]
+//      ImageString [nameCount]     (place of each name in the string table)
+//      String table (names and fuel types, not null terminated)
+//
+// Every section starts on an 8 byte boundary, and every record has a
+// fixed width so the file can be loaded with a single read (or mapping).
+// The names are the grid's name table in NameID order, each stored once,
+// and the records refer to them by NameID.  A grid with an empty name table
+// reads the names from the mapped image (see NameTable::adoptImageNames), so
+// loading does not copy or look up any name.  The areas, plants, and lines
+// are still created from their records, so loading still takes time in
+// proportion to the number of them.
+//
+// Increase GRID_IMAGE_VERSION whenever a record layout changes. An image
+// with a different version is ignored and the text files are read instead.
+//
+#include <cstdint>
+
+const uint32_t GRID_IMAGE_VERSION   = 2;
+const char     GRID_IMAGE_MAGIC[8]  = { 'R', 'G', 'R', 'I', 'D', 'I', 'M', 'G' };
+const uint32_t GRID_IMAGE_BYTEORDER = 0x01020304;   // Detects an image from a different byte order
+
+// Plant type tags stored in a PlantRecord
+enum ImagePlantType : uint32_t {
+    IMG_SOLAR = 1, IMG_WIND, IMG_HYDRO, IMG_NUCLEAR, IMG_GEOTHERMAL, IMG_GAS
+};
+
+// Place of a name in the string table
+struct ImageString {
+    uint32_t    offset;
+    uint32_t    length;
+};
+
+struct GridImageHeader {
+    char        magic[8];
+    uint32_t    version;
+    uint32_t    byteOrder;
+    uint32_t    areaCount;
+    uint32_t    plantCount;
+    uint32_t    lineCount;
+    uint32_t    nameCount;
+    uint32_t    stringTableSize;
+    uint32_t    reserved;
+    uint64_t    areaOffset;         // File offset of each section
+    uint64_t    plantOffset;
+    uint64_t    lineOffset;
+    uint64_t    nameOffset;
+    uint64_t    stringOffset;
+};
+
+// Names are stored as a NameID, the position of the name in the name section
+struct AreaRecord {
+    uint32_t    name;
+    uint32_t    reserved;
+    double      powerRequired;
+    double      mwPrice;
+};
+
+//
+// PlantRecord: One record for every plant type.  The meaning of the
+//      parameter fields depends on the type:
+//          Solar:   param1 = acres,      param2 = sunlight hours
+//          Wind:    intParam = turbines, param1 = blade length, param2 = wind speed
+//          Hydro:   param1 = flow rate,  param2 = vertical drop
+//          Nuclear: intParam = fuel rods
+//          Gas:     fuelType,            param1 = throttle percent
+//
+struct PlantRecord {
+    uint32_t    name;
+    uint32_t    fuelType;
+    uint32_t    type;               // ImagePlantType
+    int32_t     intParam;
+    double      maxOutput;
+    double      operatingCost;
+    double      param1;
+    double      param2;
+};
+
+struct LineRecord {
+    uint32_t    name;
+    int32_t     lineID;
+    double      capacity;
+    double      efficiency;
+};
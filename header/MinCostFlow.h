@@ -0,0 +1,68 @@
+#pragma once
+// File: MinCostFlow.h
+//
+// Contains the class definition for MinCostFlow, a minimum cost flow solver
+// on a directed network with real valued capacities, costs, and gains.
+//
+// The flow of an arc is what enters it at its tail.  An arc delivers its
+// flow times its gain to its head, so an arc with a gain below 1 loses part
+// of what it carries (as a transmission line does).  Every node other than
+// the source and the sink passes on all the flow it receives.
+//
+// The solver is a primal network simplex for networks with gains.  Each arc
+// is basic, or at its lower bound (0) or its upper bound (its capacity).  The
+// basic arcs make up a forest of trees over the nodes other than the source
+// and the sink, and each tree has one extra basic arc: an arc to the source
+// or the sink, or an arc that closes a cycle of the tree.  The node
+// potentials and the flow changes of a pivot are found by walking the trees
+// from their leaves, so no matrix is kept.  Each pivot brings in the arc with
+// the most negative reduced cost.  After a run of pivots that move no flow,
+// the lowest numbered arc that lowers the cost is brought in instead
+// (Bland's rule), so the solver can not cycle.
+//
+// The trees are found again from the basic arcs at each pivot, so a pivot
+// takes time in proportion to the number of nodes and arcs.
+//
+// The source and the sink can supply and take any amount, so solve() finds
+// the cheapest flow of any amount.  To get the cheapest maximum flow, give
+// the arcs into the sink a large negative cost so every unit is worth sending.
+//
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+class MinCostFlow {
+private:
+    struct Arc {
+        int     from;
+        int     to;
+        double  capacity;
+        double  cost;           // Cost per unit of flow entering the arc
+        double  gain;           // Flow leaving the arc per unit entering it
+    };
+
+    vector<Arc>     arcs;
+    vector<double>  flow;       // Flow of each arc after solve()
+    int             nodeCount;
+    int             pivots = 0;
+
+public:
+    static constexpr double EPSILON = 1e-9;    // Flow and capacity below this are zero
+
+    explicit MinCostFlow(int nodes = 0) : nodeCount(nodes) {}
+
+    int addNode() { return nodeCount++; }
+    int getNodeCount() const { return nodeCount; }
+
+    // Add an arc and return its id (used by getFlow)
+    int addArc(int from, int to, double capacity, double cost, double gain = 1.0);
+
+    // Send the cheapest flow from the source to the sink.  Returns the total
+    // cost; the net flow leaving the source is returned in totalFlow.
+    double solve(int source, int sink, double& totalFlow);
+
+    // Flow entering an arc after solve(), and the pivots solve() took
+    double getFlow(int arc) const { return arc < (int)flow.size() ? flow[arc] : 0.0; }
+    int getPivots() const { return pivots; }
+};
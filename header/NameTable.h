@@ -0,0 +1,84 @@
+#pragma once
+// File: NameTable.h
+//
+// Contains the class definition for the NameTable, the intern table for the
+// names used by a grid (plant, area, and line names and gas fuel types).
+//
+// Each different name is stored once and is identified by a small integer
+// NameID.  Plants, areas, and lines keep only the NameID of each name, and
+// their name accessors take the table of the grid they belong to and return
+// a string_view of the stored name, so no string is copied when a name is
+// printed or compared.
+//
+// Each grid owns its table (see PowerGrid::getNames) and frees it with its
+// plants, areas, and lines.  A table is not locked: only one thread at a
+// time may add or find names, though any number may view them while no
+// names are added.  The data file readers each fill a table of their own, and
+// the names are moved into the grid's table when the buffers are merged (see
+// InitializeGrid.cpp).  Names are kept in chunks that never move once they
+// are created, so a view stays valid for the life of the table.
+//
+// An empty table can take over the names of a mapped grid image (see
+// GridImage.h).  The image names keep their ids and are read from the
+// mapping, so none of them is copied.  The lookup by name is only built the
+// first time a name is found or added.
+//
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "GridFile.h"
+#include "GridImage.h"
+
+using namespace std;
+
+typedef uint32_t NameID;
+
+class NameTable {
+private:
+    static const size_t CHUNK_SIZE = 4096;  // Names in each chunk
+
+    vector<unique_ptr<string[]>>        chunks;         // Chunks of stored names
+    size_t                              nameCount = 0;  // Names in the table (image and stored)
+
+    // Names of a grid image, ids 0 to imageCount-1 (the stored names follow)
+    unique_ptr<MappedFile>              imageFile;
+    const char*                         pImageText = nullptr;
+    const ImageString*                  pImageNames = nullptr;
+    size_t                              imageCount = 0;
+
+    // Keys point into the chunks or the image.  The image names are added
+    // the first time the lookup is used.
+    mutable unordered_map<string_view, NameID>  idsByName;
+    mutable bool                                imageIndexed = true;
+
+    void indexImageNames() const;
+
+public:
+    NameTable() = default;
+
+    NameTable(const NameTable&) = delete;
+    NameTable& operator=(const NameTable&) = delete;
+
+    // Return the id of a name, adding the name if it is new
+    NameID intern(string_view name);
+
+    // Find the id of a name without adding it.  Returns false if it is not in the table.
+    bool find(string_view name, NameID& id) const;
+
+    // Take over the names of a mapped grid image (the table must be empty).
+    // pNames[i] is the place of name i in the image's string table pText.
+    void adoptImageNames(unique_ptr<MappedFile> pFile, const char* pText, const ImageString* pNames, size_t count);
+
+    // Return the text of a name (valid for the life of the table)
+    string_view view(NameID id) const {
+        if (id < imageCount)
+            return string_view(pImageText + pImageNames[id].offset, pImageNames[id].length);
+        size_t stored = id - imageCount;
+        return chunks[stored / CHUNK_SIZE][stored % CHUNK_SIZE];
+    }
+
+    size_t size() const { return nameCount; }
+};
@@ -1,3 +1,4 @@
+#pragma once
 
 //******************************************************
 // File: Plant.h
@@ -10,13 +11,48 @@
 //******************************************************
 
 #include <string>
+#include <vector>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
 #include <algorithm>
+#include <string_view>
 #include "GridDef.h"
+#include "NameTable.h"
+#include "CapacityIndex.h"
 using namespace std;
 
+class PlantStore;       // Optional column store of the plants (see PlantStore.h)
+
+//
+// PlantType:  The type of each plant.  The text of each type (PT_SOLAR, ...)
+//             is only used when reading and printing.
+//
+enum class PlantType : uint8_t { Solar, Wind, Hydro, Nuclear, Geothermal, Gas };
+
+// Returns the text of a plant type (e.g. "Solar")
+string_view plantTypeName(PlantType type);
+
+// Finds the type for the text of a plant type.  Returns false if it is not a plant type.
+bool plantTypeFromName(string_view name, PlantType& type);
+
+
+//
+// PlantState:  The state of a plant that changes while the grid is modeled
+//              (conditions, output, and allocations).  Saved and restored by
+//              the grid to run many scenarios on one loaded grid.
+//
+struct PlantState {
+    double  input1;             // Rating inputs (see getRatingInputs)
+    double  input2;
+    double  currentOutput;
+    double  availableCapacity;
+    double  capacityAllocated;
+    bool    ratingStale;
+    bool    online;
+    bool    dirty;              // In the grid's list of plants to re-dispatch
+};
+
 
 //******************************************************
 //                Power Plant                      *****
@@ -27,17 +63,50 @@ using namespace std;
 //
 class PowerPlant {
 protected:
-    string name;
-    string type;
+    NameID    nameID;                   // Name of the plant in the grid's name table
+    PlantType type;
     double maxPowerOutput = 0.0;        // The absolute maximum capacity of the plant
     double operatingCost = 0.0;    // Cost per megawatt ($)
     double currentOutput = 0.0; // Current calculated output (MW)
     double availableCapacity = 0.0; // Available output (MW)
+    double capacityAllocated = 0.0; // Output allocated to areas (MW), can be more than a lowered output
+    bool   ratingStale = true;      // A rating input changed since the output was calculated
+    bool   online = true;           // An offline plant (outage) has no output
+
+    // Connections to the grid's helper structures.  A copy of a plant starts
+    // out unconnected, so a copy never updates the helpers of the original.
+    struct PlantLinks {
+        PlantStore* pStore = nullptr;   // Plant store with a copy of the rating inputs (if any)
+        int         storeGroup = 0;
+        size_t      storeRow = 0;
+        CapacityIndex* pIndex = nullptr;  // Grid's index of available plant capacity (if any)
+        size_t      indexSlot = 0;
+        vector<size_t>* pDirtyList = nullptr;   // Grid's list of plants to re-dispatch (if any)
+        vector<size_t>* pUnratedList = nullptr; // Grid's list of plants to rate again (if any)
+        size_t      gridSlot = 0;               // Position of the plant in the grid's plant vector
+        bool        dirty = false;              // The plant is in the dirty list
+
+        PlantLinks() = default;
+        PlantLinks(const PlantLinks&) {}
+        PlantLinks& operator=(const PlantLinks&) { return *this; }
+    } links;
+
+    // Derived classes call this when one of their rating inputs is changed
+    void inputsChanged();
+
+    // Sets the rating inputs without any other change (used by restoreState)
+    virtual void setRatingInputs(double input1, double input2) = 0;
+
+    // Copies the available capacity into the capacity index (if any)
+    void capacityChanged() {
+        if (links.pIndex != nullptr)
+            links.pIndex->update(links.indexSlot, availableCapacity);
+    }
 
 public:
     // Constructors & Destructors
-    PowerPlant(const string& name, const string& type, double maxPowerOutput, double cost)
-        : name(name), type(type), maxPowerOutput(maxPowerOutput), operatingCost(cost), currentOutput(0.0), availableCapacity(0.0) {}
+    PowerPlant(NameID name, PlantType type, double maxPowerOutput, double cost)
+        : nameID(name), type(type), maxPowerOutput(maxPowerOutput), operatingCost(cost), currentOutput(0.0), availableCapacity(0.0) {}
 
     // Virtual destructor
     virtual ~PowerPlant() = default;
@@ -45,18 +114,73 @@ public:
     // Pure virtual function for output calculation
     virtual double calculateOutput() = 0;
 
+    // The (up to two) inputs of the output calculation, copied into the plant store
+    virtual void getRatingInputs(double& input1, double& input2) const = 0;
+
+    // Sets the current output calculated for the plant's conditions.  The
+    // capacity already allocated stays allocated.
+    void applyRatedOutput(double output);
+
+    // Connect the plant to a row of a plant store (nullptr to disconnect)
+    void attachStore(PlantStore* pPlantStore, int group, size_t row) {
+        links.pStore = pPlantStore;
+        links.storeGroup = group;
+        links.storeRow = row;
+    }
+
+    // Connect the plant to a slot of a capacity index (nullptr to disconnect)
+    void attachIndex(CapacityIndex* pCapacityIndex, size_t slot) {
+        links.pIndex = pCapacityIndex;
+        links.indexSlot = slot;
+    }
+
+    // Connect the plant to the grid's lists of plants with changed inputs (nullptr to disconnect)
+    void attachGridLists(vector<size_t>* pDirtyList, vector<size_t>* pUnratedList, size_t gridSlot) {
+        links.pDirtyList = pDirtyList;
+        links.pUnratedList = pUnratedList;
+        links.gridSlot = gridSlot;
+        links.dirty = false;
+    }
+    size_t getGridSlot() const { return links.gridSlot; }
+    void clearDirty() { links.dirty = false; }
+
+    // True if a rating input changed since the output was last calculated
+    bool isRatingStale() const { return ratingStale; }
+
+    // Take the plant offline (outage) or put it back online.  The plant is
+    // rated again, so an offline plant's output is 0 from the next rating.
+    void setOnline(bool isOnline) {
+        if (online != isOnline) {
+            online = isOnline;
+            inputsChanged();
+        }
+    }
+    bool isOnline() const { return online; }
+
     // Virtual function for current conditions
-    virtual string getCurrentCondition() const { return "Normal"; }
+    virtual string getCurrentCondition(const NameTable&) const { return "Normal"; }
 
     // Getters and Setters
-    string getName() const { return name; }
-    string getType() const { return type; }
+    string_view getName(const NameTable& names) const { return names.view(nameID); }
+    NameID getNameID() const { return nameID; }
+
+    // Move the names from one table to another (a read buffer's to the grid's)
+    virtual void moveNames(const NameTable& from, NameTable& to) { nameID = to.intern(from.view(nameID)); }
+    string_view getType() const { return plantTypeName(type); }
+    PlantType getPlantType() const { return type; }
     double getMaxPowerOutput() const { return maxPowerOutput; }
     double getOperatingCost() const { return operatingCost; }
     double getCurrentOutput() const { return currentOutput; }
     double getAvailableCapacity() const { return availableCapacity; }
 
     void reduceCapacity(double amount);
+    void releaseCapacity(double amount);
+    void resetCapacity();
+
+    // Save and restore the state that changes while the grid is modeled.
+    // Restoring does not update the capacity index (the grid rebuilds it).
+    void saveState(PlantState& state) const;
+    void restoreState(const PlantState& state);
     double getCapacityAllocated() const;
     double getCostOfAllocatedPower() const;
 };
@@ -65,21 +189,27 @@ public:
 //                  Solar Plant                    *****
 //******************************************************
 //
-class SolarFarm : public PowerPlant {
+class SolarFarm final : public PowerPlant {
 private:
     double numAcres;
     double sunlightHours;   // hours of sunlight today (dynamic)
 
+    void setRatingInputs(double input1, double input2) override { numAcres = input1; sunlightHours = input2; }
+
 public:
-    SolarFarm(const string& name, double maxOutput, double cost, double acres, double sunlightHours)
-        : PowerPlant(name, PT_SOLAR, maxOutput, cost), numAcres(acres), sunlightHours(sunlightHours) {}
+    SolarFarm(NameID name, double maxOutput, double cost, double acres, double sunlightHours)
+        : PowerPlant(name, PlantType::Solar, maxOutput, cost), numAcres(acres), sunlightHours(sunlightHours) {}
 
     // Dynamic sunlight affects output
     double calculateOutput() override;
+    static double outputFor(double acres, double sunlightHours) { return acres * sunlightHours / 55; }
 
-    string getCurrentCondition() const override;
+    string getCurrentCondition(const NameTable& names) const override;
+    void getRatingInputs(double& input1, double& input2) const override { input1 = numAcres; input2 = sunlightHours; }
 
-    void setSunlightHours(double hours) { sunlightHours = hours; }
+    double getNumAcres() const { return numAcres; }
+    double getSunlightHours() const { return sunlightHours; }
+    void setSunlightHours(double hours) { sunlightHours = hours; inputsChanged(); }
 };
 
 
@@ -87,22 +217,28 @@ public:
 //                  WindFarm Plant                 *****
 //    Plant using a set of windmills (turbines)    *****
 //******************************************************
-class WindFarm : public PowerPlant {
+class WindFarm final : public PowerPlant {
 private:
     int turbineCount;
     double avgWindSpeed;    // miles per hour
     double bladeLength;        // blade length
 
+    void setRatingInputs(double input1, double input2) override { turbineCount = (int)input1; avgWindSpeed = input2; }
+
 public:
-    WindFarm(string& name, double maxPowerOutput, double cost, int turbines, double bladeLen, double windSpeed)
-        : PowerPlant(name, PT_WIND,  maxPowerOutput, cost), turbineCount(turbines), bladeLength(bladeLen), avgWindSpeed(windSpeed) {}
+    WindFarm(NameID name, double maxPowerOutput, double cost, int turbines, double bladeLen, double windSpeed)
+        : PowerPlant(name, PlantType::Wind,  maxPowerOutput, cost), turbineCount(turbines), bladeLength(bladeLen), avgWindSpeed(windSpeed) {}
 
     double calculateOutput() override;
+    static double outputFor(int turbines, double windSpeed) { return turbines * windSpeed / 9.8; }
 
-    string getCurrentCondition() const override;
+    string getCurrentCondition(const NameTable& names) const override;
+    void getRatingInputs(double& input1, double& input2) const override { input1 = turbineCount; input2 = avgWindSpeed; }
 
+    int getTurbineCount() const { return turbineCount; }
+    double getAvgWindSpeed() const { return avgWindSpeed; }
     double getBladeLength() const { return bladeLength; }
-    void setAvgWindSpeed(double speed) { avgWindSpeed = speed; }
+    void setAvgWindSpeed(double speed) { avgWindSpeed = speed; inputsChanged(); }
 };
 
 
@@ -111,53 +247,69 @@ public:
 //******************************************************
 //                Hydro Electric Plant             *****
 //******************************************************
-class HydroPlant : public PowerPlant {
+class HydroPlant final : public PowerPlant {
 private:
     double inFlowRate;   // cubic meters/sec
     double verticalDrop; // meters
 
+    void setRatingInputs(double input1, double input2) override { inFlowRate = input1; verticalDrop = input2; }
+
 public:
-    HydroPlant(const string& name, double maxOutput, double cost, double flowRate, double drop)
-        : PowerPlant(name, PT_HYDRO, maxOutput, cost), inFlowRate(flowRate), verticalDrop(drop) {}
+    HydroPlant(NameID name, double maxOutput, double cost, double flowRate, double drop)
+        : PowerPlant(name, PlantType::Hydro, maxOutput, cost), inFlowRate(flowRate), verticalDrop(drop) {}
 
     double calculateOutput() override;
+    static double outputFor(double flowRate, double drop) { return flowRate * drop / 600; }
 
-    string getCurrentCondition() const override;
+    string getCurrentCondition(const NameTable& names) const override;
+    void getRatingInputs(double& input1, double& input2) const override { input1 = inFlowRate; input2 = verticalDrop; }
 
-    void setFlowRate(double flow) { inFlowRate = flow; }
-    void setVerticalDrop(double drop) { verticalDrop = drop; }
+    double getFlowRate() const { return inFlowRate; }
+    double getVerticalDrop() const { return verticalDrop; }
+    void setFlowRate(double flow) { inFlowRate = flow; inputsChanged(); }
+    void setVerticalDrop(double drop) { verticalDrop = drop; inputsChanged(); }
 };
 
 //******************************************************
 //              Nuclear Electric Plant             *****
 //******************************************************
-class NuclearPlant : public PowerPlant {
+class NuclearPlant final : public PowerPlant {
 private:
     int fuelRodsActive; // number of fuel rods
 
+    void setRatingInputs(double input1, double) override { fuelRodsActive = (int)input1; }
+
 public:
-    NuclearPlant(const string& name, double maxOutput, double cost, int rods)
-        : PowerPlant(name, PT_NUCLEAR, maxOutput, cost), fuelRodsActive(rods) {}
+    NuclearPlant(NameID name, double maxOutput, double cost, int rods)
+        : PowerPlant(name, PlantType::Nuclear, maxOutput, cost), fuelRodsActive(rods) {}
 
     double calculateOutput() override;
+    static double outputFor(int rods) { return rods * 20; }
 
-    string getCurrentCondition() const override;
+    string getCurrentCondition(const NameTable& names) const override;
+    void getRatingInputs(double& input1, double& input2) const override { input1 = fuelRodsActive; input2 = 0.0; }
 
-    void setFuelRods(int rods) { fuelRodsActive = rods; }
+    int getFuelRods() const { return fuelRodsActive; }
+    void setFuelRods(int rods) { fuelRodsActive = rods; inputsChanged(); }
 };
 
 
 //******************************************************
 //             Geothermal Electric Plant           *****
 //******************************************************
-class GeothermalPlant : public PowerPlant {
+class GeothermalPlant final : public PowerPlant {
+private:
+    void setRatingInputs(double, double) override {}
+
 public:
-    GeothermalPlant(const string& name, double maxOutput, double cost)
-        : PowerPlant(name, PT_GEOTHERMAL, maxOutput, cost) {}
+    GeothermalPlant(NameID name, double maxOutput, double cost)
+        : PowerPlant(name, PlantType::Geothermal, maxOutput, cost) {}
 
     double calculateOutput() override;
+    static double outputFor(double maxOutput) { return maxOutput; }   // Stable output, just use max
 
-    string getCurrentCondition() const override;
+    string getCurrentCondition(const NameTable& names) const override;
+    void getRatingInputs(double& input1, double& input2) const override { input1 = 0.0; input2 = 0.0; }
 };
 
 
@@ -165,19 +317,31 @@ public:
 //                   Gas Fuel Plant                *****
 // Plants using gas for fuel - natural, LP, Bio... *****
 //******************************************************
-class GasPlant : public PowerPlant {
+class GasPlant final : public PowerPlant {
 private:
-    string fuelType;
+    NameID fuelTypeID;      // Fuel type in the grid's name table
     double throttlePercent; // 0–100
 
+    void setRatingInputs(double input1, double) override { throttlePercent = input1; }
+
 public:
-    GasPlant(const string& name, double capacity, double cost, const string& fuel, double throttlePer)
-        : PowerPlant(name, PT_GAS, capacity, cost), fuelType(fuel), throttlePercent(throttlePer) {}
+    GasPlant(NameID name, double capacity, double cost, NameID fuel, double throttlePer)
+        : PowerPlant(name, PlantType::Gas, capacity, cost), fuelTypeID(fuel), throttlePercent(throttlePer) {}
 
     double calculateOutput() override;
+    static double outputFor(double maxOutput, double throttlePercent) { return maxOutput * throttlePercent / 100.0; }
+
+    string getCurrentCondition(const NameTable& names) const override;
+    void getRatingInputs(double& input1, double& input2) const override { input1 = throttlePercent; input2 = 0.0; }
 
-    string getCurrentCondition() const override;
+    string_view getFuelType(const NameTable& names) const { return names.view(fuelTypeID); }
+    NameID getFuelTypeID() const { return fuelTypeID; }
+    double getThrottle() const { return throttlePercent; }
+    void setThrottle(double throttle) { throttlePercent = throttle; inputsChanged(); }
+    void setFuelType(NameTable& names, string_view fuel) { fuelTypeID = names.intern(fuel); }
 
-    void setThrottle(double throttle) { throttlePercent = throttle; }
-    void setFuelType(const string& fuel) { fuelType = fuel; }
+    void moveNames(const NameTable& from, NameTable& to) override {
+        PowerPlant::moveNames(from, to);
+        fuelTypeID = to.intern(from.view(fuelTypeID));
+    }
 };
\ No newline at end of file
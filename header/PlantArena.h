@@ -0,0 +1,71 @@
+#pragma once
+// File: PlantArena.h
+//
+// Contains the class definition for the PlantArena, a monotonic pool that
+// owns the power plant objects of a grid.
+//
+// Plants are constructed one after another in large blocks of memory, so
+// creating a plant does not call malloc, and plants that are read together
+// sit next to each other in memory.  Plants are never freed one at a time;
+// release() (or the destructor) destroys every plant and frees all of the
+// blocks in one shot.
+//
+#include <vector>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Plant.h"
+
+using namespace std;
+
+const size_t PLANT_ARENA_BLOCK_SIZE = 64 * 1024;   // Bytes in each block of the arena
+
+class PlantArena {
+private:
+    vector<unique_ptr<char[]>>  blocks;         // Memory blocks, the last one is being filled
+    size_t                      blockUsed = 0;  // Bytes used in the last block
+    size_t                      blockSize = 0;  // Size of the last block
+    vector<PowerPlant*>         objects;        // Every plant created, destroyed by release()
+
+    void* allocate(size_t size, size_t alignment);
+
+public:
+    PlantArena() = default;
+    ~PlantArena() { release(); }
+
+    // An arena owns its plants, so it can be moved but not copied
+    PlantArena(const PlantArena&) = delete;
+    PlantArena& operator=(const PlantArena&) = delete;
+    PlantArena(PlantArena&& other) noexcept { adopt(other); }
+    PlantArena& operator=(PlantArena&& other) noexcept {
+        if (this != &other) {
+            release();
+            adopt(other);
+        }
+        return *this;
+    }
+
+    //
+    // create() - Constructs a plant of type T in the arena
+    //
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(is_base_of<PowerPlant, T>::value, "PlantArena only holds power plants");
+
+        T* pPlant = new (allocate(sizeof(T), alignof(T))) T(forward<Args>(args)...);
+        objects.push_back(pPlant);
+        return pPlant;
+    }
+
+    // Constructs a copy of a plant (of the same class) in the arena
+    PowerPlant* clone(const PowerPlant& plant);
+
+    // Take over all of the plants and memory of another arena
+    void adopt(PlantArena& other);
+
+    // Destroy every plant and free all of the memory
+    void release();
+
+    size_t size() const { return objects.size(); }
+};
@@ -0,0 +1,27 @@
+#pragma once
+// File: PlantKernels.h
+//
+// Contains batch (vectorized) versions of the plant output formulas.
+//
+// Solar, wind, hydro, and gas output are all of the form  a * b / divisor,
+// applied element by element to two columns of the plant store:
+//
+//      Solar:  acres     * sunlight hours / 55
+//      Wind:   turbines  * wind speed     / 9.8
+//      Hydro:  flow rate * vertical drop  / 600
+//      Gas:    max power * throttle %     / 100
+//
+// The batch functions use AVX2 or SSE2 when the CPU running the program
+// supports it (checked once at run time) and plain C++ loops otherwise.
+// Every version does the multiply then the divide, so the results are
+// exactly the same as the calculateOutput function of each plant class.
+//
+#include <cstddef>
+
+void rateSolarBatch(const double* acres, const double* sunlightHours, double* output, size_t count);
+void rateWindBatch(const double* turbines, const double* windSpeed, double* output, size_t count);
+void rateHydroBatch(const double* flowRate, const double* drop, double* output, size_t count);
+void rateGasBatch(const double* maxOutput, const double* throttlePercent, double* output, size_t count);
+
+// Name of the instruction set chosen at run time ("avx2", "sse2", or "scalar")
+const char* plantKernelTarget();
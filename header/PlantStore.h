@@ -0,0 +1,123 @@
+#pragma once
+// File: PlantStore.h
+//
+// Contains the class definitions for the optional struct-of-arrays plant store.
+//
+// The store keeps the plants grouped by type, with one contiguous column
+// for each attribute used to rate a plant.  The output of every plant in a
+// group is recalculated in one tight loop (no virtual calls and no pointer
+// chasing, vectorized where possible - see PlantKernels.h), and the results
+// are then written back to the plant objects so the distribution functions
+// and reports work the same as before.
+//
+// Rating input columns for each group:
+//
+//      Group        input1          input2
+//      ----------   -------------   --------------
+//      Solar        acres           sunlight hours
+//      Wind         turbine count   wind speed
+//      Hydro        flow rate       vertical drop
+//      Nuclear      fuel rods       (unused)
+//      Geothermal   (unused)        (unused)
+//      Gas          throttle %      (unused)
+//
+// The online column is 1 for a plant that is online and 0 for one that is
+// out, and the calculated output is multiplied by it (an offline plant has
+// no output, the same as PowerPlant::applyRatedOutput).
+//
+// Plants attached to the store copy any change of a rating input or of being
+// online into the store (see PowerPlant::inputsChanged), so the columns are
+// never stale.
+//
+// PlantView gives the usual PowerPlant getters for a row of the store.  The
+// rating values come from the columns; the name, type, condition text, and
+// the capacity left after distribution come from the plant object.
+//
+#include <vector>
+#include <string>
+#include "Plant.h"
+
+using namespace std;
+
+// Plant groups in the store
+enum PlantStoreGroup {
+    GROUP_SOLAR, GROUP_WIND, GROUP_HYDRO, GROUP_NUCLEAR, GROUP_GEOTHERMAL, GROUP_GAS,
+    PLANT_GROUP_COUNT
+};
+
+//
+// PlantGroup:  Columns for all of the plants of one type
+//
+struct PlantGroup {
+    vector<PowerPlant*> plants;         // Plant object of each row
+    vector<double>      maxOutput;
+    vector<double>      operatingCost;
+    vector<double>      input1;         // Rating inputs (see table above)
+    vector<double>      input2;
+    vector<double>      online;         // 1 if the plant is online, 0 if not
+    vector<double>      currentOutput;  // Output calculated by rateAll()
+
+    size_t size() const { return plants.size(); }
+};
+
+
+//
+// Class PlantView
+//
+// Read only view of one plant in the store with the PowerPlant getters
+//
+class PlantView {
+private:
+    const PlantGroup*   pGroup;
+    size_t              row;
+
+public:
+    PlantView(const PlantGroup& group, size_t index) : pGroup(&group), row(index) {}
+
+    string_view getName(const NameTable& names) const { return pGroup->plants[row]->getName(names); }
+    string_view getType() const { return pGroup->plants[row]->getType(); }
+    string getCurrentCondition(const NameTable& names) const { return pGroup->plants[row]->getCurrentCondition(names); }
+    double getMaxPowerOutput() const { return pGroup->maxOutput[row]; }
+    double getOperatingCost() const { return pGroup->operatingCost[row]; }
+    double getCurrentOutput() const { return pGroup->currentOutput[row]; }
+    double getAvailableCapacity() const { return pGroup->plants[row]->getAvailableCapacity(); }
+    double getCapacityAllocated() const { return pGroup->plants[row]->getCapacityAllocated(); }
+    double getCostOfAllocatedPower() const { return getCapacityAllocated() * getOperatingCost(); }
+};
+
+
+//
+// Class PlantStore
+//
+class PlantStore {
+private:
+    PlantGroup  groups[PLANT_GROUP_COUNT];
+
+    static int groupForType(PlantType type);
+
+public:
+    PlantStore() = default;
+    ~PlantStore() { clear(); }
+
+    // The plants point back to the store so it can not be copied
+    PlantStore(const PlantStore&) = delete;
+    PlantStore& operator=(const PlantStore&) = delete;
+
+    // Build the store from the grid's plants (replaces anything already stored)
+    void build(const vector<PowerPlant*>& plants);
+    void clear();
+
+    // Recalculate the output of every plant, one group at a time
+    void rateAll();
+
+    // Copy the calculated outputs back to the plant objects with changed inputs.
+    // Returns the change of their total output.
+    double applyToPlants();
+
+    // Copy the rating inputs of one plant into its row (called by the plant)
+    void refreshInputs(const PowerPlant* pPlant, int group, size_t row);
+
+    size_t size() const;
+    const PlantGroup& getGroup(PlantStoreGroup group) const { return groups[group]; }
+    PlantView view(PlantStoreGroup group, size_t row) const { return PlantView(groups[group], row); }
+};
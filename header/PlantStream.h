@@ -0,0 +1,95 @@
+#pragma once
+// File: PlantStream.h
+//
+// Contains the definitions used to stream plant data files that are too
+// large to hold in memory.
+//
+// A plant data file (A2_Plants.txt format) is read in fixed size chunks.
+// Each record is parsed into a PlantEntry and the entries are handed to a
+// callback in batches.  No PowerPlant objects are created, so memory use is
+// bounded by the chunk size no matter how large the file is.
+//
+// PlantStatsAggregator is a callback that keeps the capacity totals and
+// per type statistics of all the plants it is given.
+//
+// Note: Streaming requires each plant record to be on its own line (as in
+//       the data files).  The strings in a PlantEntry point into the chunk
+//       buffer and are only valid during the callback.
+//
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <functional>
+#include "GridDef.h"
+#include "GridFile.h"
+
+using namespace std;
+
+// Default sizes used when streaming a plant file
+const size_t PLANT_STREAM_CHUNK_BYTES = 1 << 20;   // Bytes read from the file at a time
+const size_t PLANT_STREAM_BATCH_SIZE  = 4096;      // Maximum entries handed to the callback at a time
+
+//
+// PlantEntry: The fields of one plant record.  The meaning of the parameter
+//      fields depends on the type (same as the grid image PlantRecord):
+//          Solar:   param1 = acres,      param2 = sunlight hours
+//          Wind:    intParam = turbines, param1 = blade length, param2 = wind speed
+//          Hydro:   param1 = flow rate,  param2 = vertical drop
+//          Nuclear: intParam = fuel rods
+//          Gas:     fuelType,            param1 = throttle percent
+//
+struct PlantEntry {
+    string_view name;
+    string_view type;
+    string_view fuelType;
+    double      maxOutput = 0.0;
+    double      operatingCost = 0.0;
+    double      param1 = 0.0;
+    double      param2 = 0.0;
+    int         intParam = 0;
+};
+
+// Results of reading one plant record (a record of a bad type is skipped)
+enum PlantParseStatus { PLANT_PARSE_OK, PLANT_PARSE_END, PLANT_PARSE_BAD_TYPE };
+
+// Read the next plant record from the scanner (used by all plant file readers)
+PlantParseStatus parsePlantEntry(TextScanner& scanner, PlantEntry& entry);
+
+// Calculate the output a plant would have under the conditions in its record
+double ratePlantEntry(const PlantEntry& entry);
+
+// Stream a plant data file, calling onBatch with each batch of entries.  Returns 0 on success.
+int streamPlantFile(const string& filename, const function<void(const vector<PlantEntry>&)>& onBatch,
+                    size_t chunkBytes = PLANT_STREAM_CHUNK_BYTES, size_t batchSize = PLANT_STREAM_BATCH_SIZE);
+
+
+//
+// Class PlantStatsAggregator
+//
+// Accumulates capacity totals and per type statistics from batches of plants.
+//
+class PlantStatsAggregator {
+public:
+    struct TypeStats {
+        long long   count = 0;
+        double      maxCapacity = 0.0;      // Total maximum capacity (MW)
+        double      ratedOutput = 0.0;      // Total output under current conditions (MW)
+        double      costWeighted = 0.0;     // Sum of cost * output, used for the average cost
+        double      minOutput = 0.0;
+        double      maxOutput = 0.0;
+    };
+
+private:
+    map<string, TypeStats, less<>> typeStats;    // Statistics for each plant type
+    TypeStats                      totals;       // Statistics for all plants
+
+    static void addToStats(TypeStats& stats, double maxCapacity, double output, double cost);
+
+public:
+    void addBatch(const vector<PlantEntry>& batch);
+    void printReport() const;
+
+    const TypeStats& getTotals() const { return totals; }
+    const map<string, TypeStats, less<>>& getTypeStats() const { return typeStats; }
+};
@@ -0,0 +1,66 @@
+#pragma once
+// File: PlantVariant.h
+//
+// Contains a closed set representation of the power plants.
+//
+// PlantValue is a std::variant over the six concrete plant classes.  Plants
+// are stored by value in a contiguous vector (no new, no pointers), and
+// functions are called through std::visit.  Because the concrete classes
+// are final, the compiler knows the exact type in each branch of the visit
+// and can inline each plant's calculateOutput formula instead of making a
+// virtual call.
+//
+// The grid still uses the pointer based plants vector.  This representation
+// is compared against it by tools/PlantBenchmark.cpp.
+//
+// Note: All functions for PlantValue are inline.  There is no PlantVariant.cpp
+//
+#include <variant>
+#include <vector>
+#include "Plant.h"
+
+using namespace std;
+
+using PlantValue = variant<SolarFarm, WindFarm, HydroPlant, NuclearPlant, GasPlant, GeothermalPlant>;
+
+// Access the common PowerPlant part of a plant value
+inline PowerPlant& asPlant(PlantValue& plant) {
+    return visit([](auto& p) -> PowerPlant& { return p; }, plant);
+}
+
+inline const PowerPlant& asPlant(const PlantValue& plant) {
+    return visit([](const auto& p) -> const PowerPlant& { return p; }, plant);
+}
+
+// Calculate the output of a plant value (no virtual call)
+inline double calculateOutput(PlantValue& plant) {
+    return visit([](auto& p) { return p.calculateOutput(); }, plant);
+}
+
+// Get the current conditions of a plant value (no virtual call)
+inline string getCurrentCondition(const PlantValue& plant, const NameTable& names) {
+    return visit([&](const auto& p) { return p.getCurrentCondition(names); }, plant);
+}
+
+//
+// toPlantValue() - Copies a plant object into a plant value
+//
+inline PlantValue toPlantValue(const PowerPlant& plant) {
+    if (auto pSolar = dynamic_cast<const SolarFarm*>(&plant))             return *pSolar;
+    if (auto pWind = dynamic_cast<const WindFarm*>(&plant))               return *pWind;
+    if (auto pHydro = dynamic_cast<const HydroPlant*>(&plant))            return *pHydro;
+    if (auto pNuclear = dynamic_cast<const NuclearPlant*>(&plant))        return *pNuclear;
+    if (auto pGas = dynamic_cast<const GasPlant*>(&plant))                return *pGas;
+    return dynamic_cast<const GeothermalPlant&>(plant);
+}
+
+//
+// toPlantValues() - Copies a vector of plant pointers into plant values
+//
+inline vector<PlantValue> toPlantValues(const vector<PowerPlant*>& plants) {
+    vector<PlantValue> values;
+    values.reserve(plants.size());
+    for (const auto pPlant : plants)
+        values.push_back(toPlantValue(*pPlant));
+    return values;
+}
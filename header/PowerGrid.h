@@ -8,14 +8,45 @@
 //
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <memory>
 
 #include "Plant.h"
 #include "ServiceArea.h"
 #include "TransmissionLine.h"
+#include "PlantStore.h"
+#include "PlantArena.h"
+#include "CapacityIndex.h"
+#include "AreaQueue.h"
+#include "SparseLP.h"
 
 // Define the tolerance used for comparing floating point numbers
 #define FP_ROUND(x) (x+double(0.001))
 
+// How allocatePowerToArea picks the transmission line for a request
+enum LineSelection {
+    LINE_FIRST_FIT,     // First line in file order with enough capacity (the original algorithm)
+    LINE_BEST_FIT       // Line with the least remaining capacity that is still enough
+};
+
+// How allocatePowerToArea picks the plant for a request
+enum PlantSelection {
+    PLANT_FIRST_FIT,    // First plant in file order with enough capacity (the original algorithm)
+    PLANT_MERIT_ORDER   // Cheapest plant (lowest operating cost) with enough capacity
+};
+
+// The order distributePower serves the areas in
+enum AreaSchedule {
+    AREA_FILE_ORDER,        // Areas in file order (the original algorithm)
+    AREA_PRICE_PRIORITY     // Highest MW price first, then largest deficit
+};
+
+// What the minimum cost flow dispatch optimizes (see FlowDispatch.cpp)
+enum FlowObjective {
+    FLOW_MAX_DELIVERY,      // Most power delivered, then the most profit
+    FLOW_MAX_PROFIT         // Most profit (power that costs more than it earns is not sent)
+};
+
 
 //
 // Class PowerGrid
@@ -41,6 +72,18 @@
 //          The distribute power function is in file distrubutePoer.cpp
 // 
 //          Most screen output and reports are in the file reports.cpp 
+// 
+//          Saving and loading the binary grid image is in the file GridImage.cpp
+// 
+//          The minimum cost flow dispatch is in the file FlowDispatch.cpp
+//
+//          The profit maximizing LP dispatch is in the file LPDispatch.cpp
+//
+//          Re-dispatching the plants whose conditions changed is in the file Redispatch.cpp
+//
+//          Saving and restoring the state of the grid for many scenarios is in the file GridState.cpp
+//
+//          Copy-on-write branches of the grid are in the file GridBranch.cpp
 //
 class PowerGrid {
 private:
@@ -50,9 +93,110 @@ private:
 
     // Vectors containing instances of plants, demands, and transmission lines
     // ***** => In assignment 2 and beyond, the plant vector contains pointers to a plant object, not a plant object.  
+    // The plant objects are owned by the plant arena and are all freed with the grid.
+    // The names of all three are kept in the grid's name table, which a branch shares.
+    shared_ptr<NameTable>    names = make_shared<NameTable>();
+    PlantArena               plantArena;
     vector<PowerPlant*>      plants;
     vector<ServiceArea>      areas;
     vector<TransmissionLine>        transmissionLines;
+
+    // Optional struct-of-arrays copy of the plants used to rate them in batches
+    PlantStore  plantStore;
+    bool        plantStoreEnabled = false;
+    bool        plantStoreStale = false;    // Plants were added since the store was built
+
+    // Index of the remaining capacity of each line (slot i is transmissionLines[i]).
+    // It is rebuilt before a distribution when lines were added or removed.
+    CapacityIndex   lineIndex;
+    bool            lineIndexStale = true;
+    LineSelection   lineSelection = LINE_FIRST_FIT;
+
+    // Index of the available capacity of each plant (slot i is plantIndexOrder[i]).
+    // The slots are in file order, or in order of operating cost for merit
+    // order dispatch.  It is rebuilt before a distribution when plants were
+    // added or removed or the plant selection changed.
+    CapacityIndex       plantIndex;
+    vector<PowerPlant*> plantIndexOrder;
+    vector<size_t>      plantIndexSlot;     // Slot of each plant (plantIndexOrder[plantIndexSlot[i]] is plants[i])
+    bool                plantIndexStale = true;
+    PlantSelection      plantSelection = PLANT_FIRST_FIT;
+
+    // Priority queue of the areas that need power, used for price priority
+    // scheduling.  It is rebuilt when areas were added or removed.
+    AreaQueue       areaQueue;
+    bool            areaQueueStale = true;
+    AreaSchedule    areaSchedule = AREA_FILE_ORDER;
+
+    // LP of the profit maximizing dispatch.  It is kept between solves so each
+    // solve warm starts, and rebuilt when plants, areas, or lines were added.
+    SparseLP    dispatchLP;
+    bool        dispatchLPStale = true;
+
+    // Ledger of the allocations made by distributePower, used to re-dispatch a
+    // plant, line, or area that changed.  The allocations of each plant, line,
+    // and area are linked newest first (plantAllocations[i] is the newest
+    // allocation of plants[i]), so the allocations of one of them are found
+    // without a scan.  A released allocation is marked dead and stays in the
+    // vector until the ledger is cleared or compacted.
+    struct Allocation {
+        size_t  plant;          // Index in plants
+        size_t  area;           // Index in areas
+        size_t  line;           // Index in transmissionLines
+        double  requested;      // MW requested for the area
+        double  drawn;          // MW taken from the plant
+        double  delivered;      // MW added to the area and the line
+        size_t  nextForPlant;   // Next older allocation of the same plant
+        size_t  nextForLine;    // ... on the same line
+        size_t  nextForArea;    // ... to the same area
+        bool    live;           // Not released
+    };
+    static constexpr size_t NO_ALLOCATION = SIZE_MAX;
+    vector<Allocation>  allocations;
+    vector<size_t>      plantAllocations;   // Newest allocation of each plant (or NO_ALLOCATION)
+    vector<size_t>      lineAllocations;    // Newest allocation on each line (sized when first used)
+    vector<size_t>      areaAllocations;    // Newest allocation to each area (sized when first used)
+    size_t              deadAllocations = 0;
+    vector<size_t>      dirtyPlants;        // Plants with inputs changed since the last dispatch
+
+    // Plants with inputs changed since they were last rated, and the total
+    // output of all plants as last rated
+    vector<size_t>  unratedPlants;
+    double          ratedOutputTotal = 0.0;
+
+    // Saved state of the plants, areas, and lines (see saveBaseline).  Each
+    // array is in the order of the grid's vectors, so a restore is one pass.
+    struct AreaUsage {
+        double  required;
+        double  provided;
+    };
+    struct LineUsage {
+        double  inUse;
+        double  available;
+        double  usableFraction;
+    };
+    struct Baseline {
+        vector<PlantState>  plants;
+        vector<AreaUsage>   areas;
+        vector<LineUsage>   lines;
+        vector<Allocation>  allocations;        // The allocation ledger
+        vector<size_t>      plantAllocations;
+        vector<size_t>      lineAllocations;
+        vector<size_t>      areaAllocations;
+        size_t              deadAllocations = 0;
+        vector<size_t>      dirtyPlants;
+        double              ratedOutputTotal = 0.0;
+        bool                saved = false;
+    } baseline;
+
+    // A copy-on-write branch shares the plants of the grid it was made from
+    // until it changes one (see GridBranch.cpp).  plantShared[i] is 1 while
+    // plants[i] is still the other grid's plant.  Empty if the grid is not a branch.
+    vector<uint8_t>     plantShared;
+    size_t              inheritedPlantCount = 0;    // Plants that came from the other grid
+
+    bool    splitAllocations = false;   // Fill a request from several plants and lines when needed
+    bool    verbose = true;         // Print each allocation while distributing power
     
     
     // Variables used for the power distribution algorithim
@@ -61,32 +205,141 @@ private:
     int     areasRequirePower;      // Flag if any areas have unmet power requierments 
     int     nextLineIndex;          // Used to track what transLine to use
 
+    // Functions that read a data file into a buffer (may run on any thread) and
+    // functions that add a buffer to the grid : in file InitializeGrid.cpp and PowerGrid.cpp
+    // Each buffer has a name table and a message stream of its own, so the readers do not share them.
+    static int parseServiceAreaFile(const string& filename, vector<ServiceArea>& areaBuffer, NameTable& bufferNames, ostream& errors);
+    static int parsePlantFile(const string& filename, vector<PowerPlant*>& plantBuffer, PlantArena& plantArena, NameTable& bufferNames, ostream& errors);
+    static int parseTransmissionLineFile(const string& filename, vector<TransmissionLine>& lineBuffer, NameTable& bufferNames, ostream& errors);
+    void mergeServiceAreas(vector<ServiceArea>& areaBuffer, const NameTable& bufferNames);
+    void mergePlants(vector<PowerPlant*>& plantBuffer, PlantArena& bufferArena, const NameTable& bufferNames);
+    void mergeTransmissionLines(vector<TransmissionLine>& lineBuffer, const NameTable& bufferNames);
+
+    // Functions used to find the line and plant for a request : in file DistPower.cpp and PowerGrid.cpp
+    void rebuildLineIndex();
+    void rebuildPlantIndex();
+    void rebuildAreaQueue();
+    void serveArea(ServiceArea& area, int areaPercentage);
+    void allocateInFragments(ServiceArea& area, double powerRequested);
+    TransmissionLine* findLineForPower(double powerRequested);
+    PowerPlant* findPlantForPower(double plantPowerRequested);
+    void buildDispatchLP();
+
+    // Functions for the allocation ledger : in file DistPower.cpp and Redispatch.cpp
+    void recordAllocation(ServiceArea& area, PowerPlant* pPlant, TransmissionLine* pLine,
+                          double requested, double drawn, double delivered);
+    void clearAllocationLedger();
+    void releaseAllocation(size_t i);
+    void requestAgain(vector<size_t>& released);
+    bool requestShortfall(ServiceArea& area);
+    void moveOverAllocations(const vector<size_t>& slots);
+    void compactAllocationLedger();
+
+    // Copy-on-write of the plants of a branch : in file GridBranch.cpp
+    bool isPlantShared(size_t i) const { return i < plantShared.size() && plantShared[i] != 0; }
+    PowerPlant* ownPlant(PowerPlant* pPlant) { return writablePlant(pPlant->getGridSlot()); }
 
 
 
 public:
+    PowerGrid() = default;
+    ~PowerGrid() { clearGrid(); }
+
+    // The grid owns its plants so it can not be copied
+    PowerGrid(const PowerGrid&) = delete;
+    PowerGrid& operator=(const PowerGrid&) = delete;
+
+    // Remove every plant, area, and line (called before the grid is initialized again)
+    void clearGrid();
+
+    // Table of the plant, area, and line names of the grid
+    NameTable& getNames() { return *names; }
+    const NameTable& getNames() const { return *names; }
+
     // Function called to read the data files and fill the data of the Grid
-    int initializeGrid(const string gridName, const string plantFilename, const string TransLineFilename, const string AreaFilename);
+    // If the grid image file is newer than all of the data files the image is loaded instead.
+    int initializeGrid(const string gridName, const string plantFilename, const string TransLineFilename, const string AreaFilename,
+                       const string imageFilename = GRID_IMAGE_FILENAME);
+
+    // Functions to save and load a precompiled binary image of the grid : in file GridImage.cpp
+    int  writeGridImage(const string& filename) const;
+    int  readGridImage(const string& filename);
+    static bool isGridImageCurrent(const string& imageFilename, const vector<string>& sourceFilenames);
 
     // Functions to add, remove, read data file, manage, and print the power plants
-    void addPlantToGrid(PowerPlant* pPlant);
+    void addPlantToGrid(PowerPlant* pPlant);        // The plant's names must be in getNames()
     int  readPlantData(const string& filename);
     void adjustPlantsForConditions();   // Calls each plant to adjust for unique conditions
+    void enablePlantStore(bool enable); // Rate the plants in batches using the plant store
+    const PlantStore& getPlantStore() const { return plantStore; }
     void printPlants() const;
+    const vector<PowerPlant*>& getPlants() const { return plants; }     // Change a plant through writablePlant
+    void setPlantSelection(PlantSelection mode);
+    PlantSelection getPlantSelection() const { return plantSelection; }
 
     // Functions to add, remove, read data file, manage, and print the Service Area locations
     int  readServceAreaData(const string& filename);
-    void addServiceArea(const string name, const double requiredCap, const double costPerMW);
+    void addServiceArea(string_view name, const double requiredCap, const double costPerMW);
     void printServceAreas() const;
+    const vector<ServiceArea>& getAreas() const { return areas; }
+    void setAreaDemand(size_t i, double required) { areas[i].setPowerRequired(required); }
+    void setAreaSchedule(AreaSchedule mode);
+    AreaSchedule getAreaSchedule() const { return areaSchedule; }
 
     // Functions to add, remove, read data file, manage, and print the transmison lines
     int  readTransmissionLineData(const string& filename);
-    void addTransmissionLine(int lineID, string lineName, double capacity, double efficiency);
+    void addTransmissionLine(int lineID, string_view lineName, double capacity, double efficiency);
     void printTransmissionLines() const;
+    void setLineSelection(LineSelection mode);
+    LineSelection getLineSelection() const { return lineSelection; }
+    const vector<TransmissionLine>& getTransmissionLines() const { return transmissionLines; }
+    void derateLine(size_t i, double fraction) { transmissionLines[i].derate(fraction); }    // 0 is an outage
 
     // Functions to distribute power : in file DistPower.cpp
     void distributePower(int percentOfRequired);    // Distributes power to the service areas
     void allocatePowerToArea(ServiceArea& area, double powerRequested);  // Allocates power & line capacity to an area
     void generateUsageReport();                     // Generates a power report to the console
+    void setVerbose(bool printAllocations) { verbose = printAllocations; }
+    bool getVerbose() const { return verbose; }
+    void setSplitAllocations(bool split) { splitAllocations = split; }
+    bool getSplitAllocations() const { return splitAllocations; }
+
+    // Totals of the current distribution : in file Reports.cpp
+    double getTotalPowerRequired() const;           // MW required by all areas
+    double getTotalPowerSupplied() const;           // MW delivered to all areas
+    double getTotalRevenue() const;                 // Paid by all areas for the power delivered
+    double getTotalOperatingCost() const;           // Cost of the power drawn from all plants
+
+    // Dispatch with a minimum cost flow instead of distributePower : in file FlowDispatch.cpp
+    double optimizeDispatch(FlowObjective objective = FLOW_MAX_DELIVERY);
+
+    // Dispatch for the most operating profit with a linear program : in file LPDispatch.cpp
+    double optimizeProfit();
+
+    // Re-rate the plants whose inputs changed since the last dispatch and move
+    // only the allocations of those plants : in file Redispatch.cpp
+    // (the areas of the released allocations are added to pMovedAreas, if given)
+    int redispatchDirtyPlants(vector<size_t>* pMovedAreas = nullptr);
+    size_t getDirtyPlantCount() const { return dirtyPlants.size(); }
+
+    // Move only the power affected by one change to a line or an area, or
+    // fill the listed areas that are short of power : in file Redispatch.cpp
+    int redispatchLine(size_t i, vector<size_t>* pMovedAreas = nullptr);  // After derateLine: moves the power over the line's new limit
+    int redispatchArea(size_t i);   // After setAreaDemand: gives back extra power or requests the shortfall
+    int serveAreas(const vector<size_t>& areaIndexes);  // Requests the shortfall of each listed area
+    void getDispatchedAssets(vector<uint8_t>& plantUsed, vector<uint8_t>& lineUsed) const;
+    double getLedgerTotals(vector<double>& plantDrawn) const;    // Power drawn from each plant; returns the power delivered
+    double getTotalRatedOutput() const { return ratedOutputTotal; }
+
+    // Run many scenarios on one loaded grid : in file GridState.cpp
+    void saveBaseline();            // Save the conditions, output, and allocations of everything
+    bool restoreBaseline();         // Put back the saved state (false if none or the grid changed)
+    void clearDispatch();           // Release every allocation, keeping the conditions and output
+
+    // Copy-on-write branches for what-if scenarios : in file GridBranch.cpp
+    // The grid a branch is made from must not change, and must outlive the branch.
+    unique_ptr<PowerGrid> branch() const;
+    PowerPlant* writablePlant(size_t i);    // Plant i, copied into this grid first if it is shared
+    bool isBranch() const { return !plantShared.empty(); }
 }; 
 
@@ -0,0 +1,95 @@
+#pragma once
+// File: ScenarioEngine.h
+//
+// Contains the class definitions for the Monte Carlo weather scenario engine.
+//
+// Each scenario draws the weather (sunlight hours, wind speed, river flow,
+// and the gas throttle setting) from the distributions in a ScenarioConfig,
+// rates the plants for that weather, and runs the same distribution as
+// main() (60% then 10% four times).  The unmet demand and the profit of
+// every scenario are kept, and summarized as percentiles.
+//
+// A draw is a factor applied to the value in the data file (e.g. a sunlight
+// factor of 0.5 halves the sunlight hours of every solar farm).  With shared
+// weather one set of factors is drawn for each scenario and used for every
+// plant (regional weather); otherwise every plant gets its own draw.
+//
+// The scenarios run in parallel on a WorkStealingPool.  Each worker has its
+// own copy-on-write branch of the grid (see GridBranch.cpp), which copies
+// only the plants the weather changes, and restores it before each scenario
+// (see GridState.cpp).  The random numbers of a scenario depend only on the
+// seed and the scenario number, so the results do not depend on the number
+// of threads.
+//
+#include <vector>
+#include "PowerGrid.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+// Distribution of a weather factor
+enum DistributionType {
+    DIST_FIXED,     // Always value1
+    DIST_UNIFORM,   // Uniform between value1 and value2
+    DIST_NORMAL     // Normal with mean value1 and standard deviation value2 (not below 0)
+};
+
+struct WeatherDistribution {
+    DistributionType    type = DIST_FIXED;
+    double              value1 = 1.0;
+    double              value2 = 0.0;
+};
+
+struct ScenarioConfig {
+    size_t              scenarios = 1000;
+    unsigned long long  seed = 1;
+    bool                sharedWeather = true;   // One draw per scenario for all plants
+    WeatherDistribution sunlight;               // Factors for sunlight hours (solar)
+    WeatherDistribution windSpeed;              // Wind speed (wind)
+    WeatherDistribution inflow;                 // River flow rate (hydro)
+    WeatherDistribution throttle;               // Throttle % (gas, not above 100%)
+};
+
+// Summary of one result over all of the scenarios
+struct ScenarioStats {
+    double  mean = 0.0;
+    double  minimum = 0.0;
+    double  p5 = 0.0;
+    double  p25 = 0.0;
+    double  p50 = 0.0;
+    double  p75 = 0.0;
+    double  p95 = 0.0;
+    double  maximum = 0.0;
+};
+
+struct ScenarioResults {
+    vector<double>  unmetDemand;    // MW of demand not met, for each scenario
+    vector<double>  profit;         // Revenue - operating cost, for each scenario
+    double          seconds = 0.0;  // Time used to run all of the scenarios
+
+    static ScenarioStats summarize(const vector<double>& values);
+};
+
+
+class ScenarioEngine {
+private:
+    const PowerGrid&    grid;       // Rated grid the scenarios branch from
+    WorkStealingPool&   pool;
+
+    struct WeatherFactors {
+        double  sunlight;
+        double  windSpeed;
+        double  inflow;
+        double  throttle;
+    };
+    template <typename Random>
+    static WeatherFactors drawWeather(const ScenarioConfig& config, Random& random);
+    static void applyWeather(PowerGrid& scenarioGrid, const ScenarioConfig& config, size_t scenario);
+
+public:
+    // The grid must be rated (adjustPlantsForConditions) and must not change
+    // while the engine runs
+    ScenarioEngine(const PowerGrid& ratedGrid, WorkStealingPool& workers) : grid(ratedGrid), pool(workers) {}
+
+    ScenarioResults run(const ScenarioConfig& config);
+};
@@ -11,24 +11,44 @@
 // quickly report on the status of if their requiermends are satisfied.
 // 
 #include <string>
+#include <string_view>
 #include <cmath>
+#include "NameTable.h"
+#include "AreaQueue.h"
 
 using namespace std;
 
 class ServiceArea {
 protected:
-    string          areaName;         
+    NameID          areaNameID;     // Name of the area in the grid's name table
     double          powerRequired;  // Total power (MW) this area needs 
     double          powerReceived;  // Amount of power (MW) currently provided
     double          mwPrice;        // Price ($) this area pays per MW
     enum AllocStatus { ACTIVE, INACTIVE } allocStatus;
     enum SupplyStatus { NOT_MET, PARTIAL_MET, FULLY_MET } status;
+
+    // The grid's priority queue of areas (if any).  A copy of an area starts
+    // out unconnected, so a copy never updates the queue of the original.
+    struct AreaLinks {
+        AreaQueue*  pQueue = nullptr;
+        size_t      queueIndex = 0;
+
+        AreaLinks() = default;
+        AreaLinks(const AreaLinks&) {}
+        AreaLinks& operator=(const AreaLinks&) { return *this; }
+    } links;
+
+    // Copies the deficit into the area queue (if any)
+    void deficitChanged() {
+        if (links.pQueue != nullptr)
+            links.pQueue->update(links.queueIndex, getPowerDeficit());
+    }
  
 
 public:
   // Constructor
-    ServiceArea(const string& name, double requiredCapacity, double price)
-        : areaName(name), powerRequired(requiredCapacity), powerReceived(0.0), mwPrice(price) {
+    ServiceArea(NameID name, double requiredCapacity, double price)
+        : areaNameID(name), powerRequired(requiredCapacity), powerReceived(0.0), mwPrice(price) {
         allocStatus = ACTIVE;
         status = NOT_MET;
     }
@@ -36,6 +56,9 @@ public:
     // Add power to the area (capped by requirement)
     void addCapacity(double amount);
 
+    // Take back power that was provided to the area
+    void removeCapacity(double amount);
+
     // Returns how much more power is needed
     double getPowerDeficit() const { 
         return fabs(powerRequired - powerReceived); 
@@ -48,7 +71,11 @@ public:
     }
 
     // Accessors
-    string getAreaName() const { return areaName; }
+    string_view getAreaName(const NameTable& names) const { return names.view(areaNameID); }
+    NameID getAreaNameID() const { return areaNameID; }
+
+    // Move the name from one table to another (a read buffer's to the grid's)
+    void moveNames(const NameTable& from, NameTable& to) { areaNameID = to.intern(from.view(areaNameID)); }
     double getPowerRequired() const { return powerRequired; }
     double getPowerProvided() const { return powerReceived; }
     double getMWPrice() const { return mwPrice; }
@@ -58,5 +85,18 @@ public:
         return powerReceived >= powerRequired;
     }
     
-    void resetPower() { powerReceived = 0.0; }
+    void resetPower() { powerReceived = 0.0; deficitChanged(); }
+
+    // Change the power the area needs (e.g. the demand of a new interval)
+    void setPowerRequired(double required) { powerRequired = required; deficitChanged(); }
+
+    // Set the power required and received without updating the area queue
+    // (the grid rebuilds it after restoring every area)
+    void restorePower(double required, double received) { powerRequired = required; powerReceived = received; }
+
+    // Connect the area to an entry of an area queue (nullptr to disconnect)
+    void attachQueue(AreaQueue* pAreaQueue, size_t index) {
+        links.pQueue = pAreaQueue;
+        links.queueIndex = index;
+    }
 };
\ No newline at end of file
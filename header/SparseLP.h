@@ -0,0 +1,113 @@
+#pragma once
+// File: SparseLP.h
+//
+// Contains the class definition for SparseLP, a small linear program solver
+// (bounded variable revised simplex) with no outside dependencies.
+//
+//      minimize    c'x
+//      subject to  each row:  a'x <= b   or   a'x = b
+//                  lower <= x <= upper
+//
+// The constraint matrix is stored by column and only the non-zero entries
+// are kept.  Each row gets a slack column, and the first basis is made of
+// the slacks.  Both the row right hand sides and the variable lower bounds
+// are expected to make that basis feasible.  That holds for the dispatch
+// LP: every lower bound is 0 and every right hand side is 0 or more.
+//
+// Warm start:  the basis of the last solve is kept.  After the bounds or the
+// right hand sides are changed (e.g. a plant's output changed), solve()
+// starts from that basis:
+//  - If it is still feasible, the primal simplex continues from it.
+//  - The costs did not change, so the basis is still dual feasible.  The
+//    dual simplex repairs the infeasible rows, usually in a few pivots.
+//  - If neither works, the solve starts over from the slack basis.
+//
+// The basis inverse is kept as a dense m x m matrix (m = number of rows).  It
+// is updated at each pivot and rebuilt from scratch every REFACTOR_PERIOD
+// pivots to limit rounding error.
+//
+#include <vector>
+#include <cstddef>
+#include <limits>
+
+using namespace std;
+
+enum LPRowType { LP_LESS_EQUAL, LP_EQUAL };
+enum LPStatus  { LP_OPTIMAL, LP_INFEASIBLE, LP_UNBOUNDED, LP_ITERATION_LIMIT };
+
+class SparseLP {
+private:
+    struct Entry {
+        int     row;
+        double  value;
+    };
+    enum VarStatus : unsigned char { BASIC, AT_LOWER, AT_UPPER };
+
+    // The model (structural columns first, then one slack column per row)
+    vector<vector<Entry>>   columns;        // Non-zero entries of each structural column
+    vector<double>          cost;           // Of the structural columns
+    vector<double>          lower;          // Of the structural columns
+    vector<double>          upper;
+    vector<double>          rhs;            // Of each row
+    vector<LPRowType>       rowType;
+
+    // The solve state
+    vector<int>             basic;          // Column that is basic in each row
+    vector<VarStatus>       status;         // Of all columns
+    vector<double>          x;              // Value of all columns
+    vector<double>          basisInverse;   // m x m, row major
+    bool                    haveBasis = false;
+    bool                    lastWarm = false;
+    int                     iterations = 0;
+
+    static const int REFACTOR_PERIOD = 64;
+
+    int    rowCount() const { return (int)rhs.size(); }
+    int    structCount() const { return (int)columns.size(); }
+    int    columnCount() const { return structCount() + rowCount(); }
+    double columnCost(int j) const { return j < structCount() ? cost[j] : 0.0; }
+
+    // Bounds of any column.  A slack is >= 0, and is fixed at 0 for an equal row.
+    double columnLower(int j) const { return j < structCount() ? lower[j] : 0.0; }
+    double columnUpper(int j) const {
+        return j < structCount() ? upper[j] : (rowType[j - structCount()] == LP_EQUAL ? 0.0 : INF);
+    }
+
+    bool   factorBasis();
+    void   computeBasicValues();
+    void   computeDuals(vector<double>& y) const;
+    double reducedCost(int j, const vector<double>& y) const;
+    void   solveColumn(int j, vector<double>& w) const;    // w = B^-1 * column j
+    void   pivot(int row, int entering, const vector<double>& w);
+    bool   isPrimalFeasible() const;
+    bool   isDualFeasible() const;
+    void   coldStart();
+    LPStatus primalSimplex(int iterationLimit);
+    LPStatus dualSimplex(int iterationLimit);
+
+public:
+    static constexpr double INF = numeric_limits<double>::infinity();
+    static constexpr double TOLERANCE = 1e-9;
+
+    SparseLP() = default;
+
+    // Build the model.  Adding a row or a column drops the kept basis.
+    int  addRow(LPRowType type, double rhs);
+    int  addVariable(double lower, double upper, double cost);
+    void addCoefficient(int row, int var, double value);
+    void clear();
+
+    // Change the model between solves (the basis is kept for a warm start)
+    void setRhs(int row, double value) { rhs[row] = value; }
+    void setBounds(int var, double lo, double up) { lower[var] = lo; upper[var] = up; }
+    void setCost(int var, double value) { cost[var] = value; }
+
+    LPStatus solve();
+
+    double getValue(int var) const { return x[var]; }
+    double getObjective() const;
+    int    getIterations() const { return iterations; }    // Pivots used by the last solve
+    bool   wasWarmStart() const { return lastWarm; }
+    int    getRowCount() const { return rowCount(); }
+    int    getVariableCount() const { return structCount(); }
+};
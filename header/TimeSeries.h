@@ -0,0 +1,78 @@
+#pragma once
+// File: TimeSeries.h
+//
+// Contains the class definition for the time-stepped simulation, which
+// models the grid over a series of intervals (e.g. the 24 hours of a day or
+// the 8760 hours of a year) instead of a single instant.
+//
+// The input is a comma separated file with one column for each plant
+// condition or area demand that changes, and one row for each interval:
+//
+//      interval,demand:AnnArbor,sunlight:Sand Dune,wind:Thumb Wind Farm
+//      1,250,0,11.5
+//      2,238,,12.0
+//
+// The first column labels the interval.  Every other column heading is
+// <input>:<plant or area name>, where the input is one of
+//      demand     area demand (MW)
+//      sunlight   sunlight hours (Solar)
+//      wind       wind speed (Wind)
+//      flow       water flow rate (Hydro)
+//      rods       fuel rods active (Nuclear)
+//      throttle   throttle % (Gas)
+// An empty field leaves the value of the last interval.  Lines starting
+// with # are comments.
+//
+// For each interval the changes are applied, the power of the last
+// interval is released (clearDispatch), only the plants whose conditions
+// changed are rated again, and the distribution from main() is run (60%
+// then 10% four times).  One row of totals is appended to the results file.
+//
+// The input is read one line at a time and the results are written as each
+// interval ends, so memory use does not grow with the number of intervals.
+//
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include "GridDef.h"
+#include "PowerGrid.h"
+
+using namespace std;
+
+// The value a column of the input file sets
+enum SeriesInput {
+    SERIES_DEMAND,
+    SERIES_SUNLIGHT,
+    SERIES_WIND,
+    SERIES_FLOW,
+    SERIES_RODS,
+    SERIES_THROTTLE
+};
+
+class TimeSeriesSimulation {
+private:
+    PowerGrid&  grid;
+
+    struct SeriesColumn {
+        SeriesInput input;
+        size_t      index;      // Position in getAreas() (demand) or getPlants()
+    };
+    vector<SeriesColumn>    columns;    // Columns after the interval label
+    size_t                  intervals = 0;
+
+    int  parseHeader(string_view header);
+    bool applyInterval(string_view line, string_view& label);
+    void dispatchInterval();
+    void writeResults(ofstream& results, string_view label);
+
+public:
+    explicit TimeSeriesSimulation(PowerGrid& simGrid) : grid(simGrid) {}
+
+    // Runs every interval of the input file and writes the results file.
+    // Returns 0 on success.
+    int run(const string& inputFilename = TIMESERIES_FILENAME,
+            const string& resultsFilename = TIMESERIES_RESULTS_FILENAME);
+
+    size_t getIntervalCount() const { return intervals; }
+};
@@ -14,26 +14,42 @@
 //
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <cassert>
+#include <algorithm>
+#include "NameTable.h"
+#include "CapacityIndex.h"
 
 using namespace std;
 
 class TransmissionLine{
 protected:
     int     lineID;
-    string  lineName;
+    NameID  lineNameID;     // Name of the line in the grid's name table
     double  maxCapacity;    // The maximum amount of power this line can transmit. (In megawatts)
     double  capacityInUse;  // The amount of power currently in use (gross - before efficency drop)
     double  availableCapacity;
     double  efficiency;     // Indicates how much supplied power is actually delivered (range: 0-100)
+    double  usableFraction = 1.0;   // Share of maxCapacity in service (0 when the line is out)
+
+    // The grid's index of remaining line capacity (if any).  A copy of a line
+    // starts out unconnected, so a copy never updates the index of the original.
+    struct LineLinks {
+        CapacityIndex*  pIndex = nullptr;
+        size_t          slot = 0;
+
+        LineLinks() = default;
+        LineLinks(const LineLinks&) {}
+        LineLinks& operator=(const LineLinks&) { return *this; }
+    } links;
 
 
     // All methods must be inline for this class !!!
 
 public:
     // Constructors & Destructors
-   TransmissionLine(int id, const string& name, double capacity, double eff)
-        : lineID(id), lineName(name), maxCapacity(capacity), capacityInUse(0.0), availableCapacity(maxCapacity), efficiency(eff) {}
+   TransmissionLine(int id, NameID name, double capacity, double eff)
+        : lineID(id), lineNameID(name), maxCapacity(capacity), capacityInUse(0.0), availableCapacity(maxCapacity), efficiency(eff) {}
 
     
 
@@ -43,19 +59,68 @@ public:
         if(powerAmount <= availableCapacity) {
             capacityInUse += powerAmount;
             availableCapacity -= powerAmount; // Reduces the available capacity
+            if (links.pIndex != nullptr)
+                links.pIndex->update(links.slot, availableCapacity);
         }
     }
 
+    // Give back capacity that was used to carry power to an area
+    void releaseCapacity(double powerAmount) {
+        powerAmount = min(powerAmount, capacityInUse);
+        capacityInUse -= powerAmount;
+        availableCapacity += powerAmount;
+        if (usableFraction < 1.0)
+            availableCapacity = min(availableCapacity, max(0.0, maxCapacity * usableFraction - capacityInUse));
+        if (links.pIndex != nullptr)
+            links.pIndex->update(links.slot, availableCapacity);
+    }
+
+    // Connect the line to a slot of a capacity index (nullptr to disconnect)
+    void attachIndex(CapacityIndex* pCapacityIndex, size_t slot) {
+        links.pIndex = pCapacityIndex;
+        links.slot = slot;
+    }
+
     // Return how much capacity is still available
     double getRemainingCapacity() const {
         return availableCapacity;
     }
     // Accessors - Geters and Setters
     int getLineID() const { return lineID; }
-    string getLineName() const { return lineName; }
+    string_view getLineName(const NameTable& names) const { return names.view(lineNameID); }
+    NameID getLineNameID() const { return lineNameID; }
+
+    // Move the name from one table to another (a read buffer's to the grid's)
+    void moveNames(const NameTable& from, NameTable& to) { lineNameID = to.intern(from.view(lineNameID)); }
     double getMaxCapacity() const { return maxCapacity; }
     double getEfficiency() const { return efficiency; }
 
 // Reset line usage
-    void resetCapacity() { capacityInUse = 0.0; }
+    void resetCapacity() {
+        capacityInUse = 0.0;
+        availableCapacity = maxCapacity * usableFraction;
+        if (links.pIndex != nullptr)
+            links.pIndex->update(links.slot, availableCapacity);
+    }
+
+    // Limit the line to a fraction of its capacity (0 takes the line out of
+    // service, 1 puts it back in full).  Power already on the line stays on
+    // it, but no more is carried while it is over the limit.
+    void derate(double fraction) {
+        usableFraction = clamp(fraction, 0.0, 1.0);
+        availableCapacity = max(0.0, maxCapacity * usableFraction - capacityInUse);
+        if (links.pIndex != nullptr)
+            links.pIndex->update(links.slot, availableCapacity);
+    }
+    double getUsableFraction() const { return usableFraction; }
+
+    // Set the power in use, the capacity left, and the derating without
+    // updating the capacity index (the grid rebuilds it after restoring
+    // every line)
+    void restoreUsage(double inUse, double available, double fraction) {
+        capacityInUse = inUse;
+        availableCapacity = available;
+        usableFraction = fraction;
+    }
+    double getCapacityInUse() const { return capacityInUse; }
 }; 
@@ -0,0 +1,116 @@
+#pragma once
+// File: UnitCommitment.h
+//
+// Contains the class definitions for the multi-period unit commitment, which
+// schedules the throttle of every gas plant and the fuel rods of every
+// nuclear plant over a series of periods (e.g. the 168 hours of a week) for
+// the least operating cost.
+//
+// A setting can only change so much from one period to the next (the ramp
+// limits in GridDef.h), starting from the plant's setting in the grid.  The
+// other plants (solar, wind, hydro, geothermal) run at their rated output in
+// every period.  The scheduled plants must make up the rest of the demand,
+// plus the power lost on the transmission lines.  Demand that is not covered
+// costs unservedCost for each MW.
+//
+// The demand of each period is the only thing that ties the plants
+// together, so it is relaxed with a price for each period (Lagrangian
+// relaxation).  For a given set of prices every plant is scheduled on its
+// own by a dynamic program over its settings (throttle steps or rods) and
+// periods, with the ramp limit on the moves from one period to the next.
+// The plants are scheduled in parallel on a WorkStealingPool, and the prices
+// are moved toward the demand (subgradient steps) until the schedules cover
+// it.
+//
+// The relaxed schedules do not have to match the demand exactly, so a
+// schedule that keeps to the ramp limits is made from them: each plant in
+// turn (most expensive first, then cheapest first) is scheduled again by the
+// same dynamic program for what the other plants leave uncovered.  The
+// cheapest of these schedules is kept.  The relaxation also gives a lower
+// bound, so the cost of the schedule can be compared with the best possible.
+//
+// applyPeriod sets the scheduled throttles and fuel rods of one period on a
+// grid, which is then rated and dispatched as usual.
+//
+#include <vector>
+#include <cstdint>
+#include "GridDef.h"
+#include "PowerGrid.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+struct CommitmentConfig {
+    vector<double>  demand;                 // MW the areas require in each period
+    double  gasRampPercent = GAS_RAMP_PERCENT;
+    int     nuclearRampRods = NUCLEAR_RAMP_RODS;
+    double  throttleStep = THROTTLE_STEP_PERCENT;
+    int     iterations = 60;                // Most price updates
+    double  unservedCost = 0.0;             // $ for each MW not covered (0 = highest area price)
+};
+
+struct CommitmentSchedule {
+    size_t          periods = 0;
+    vector<size_t>  plants;                 // Positions in getPlants() of the scheduled plants
+    vector<double>  settings;               // Throttle % or fuel rods of plant p in period t at [p * periods + t]
+    vector<double>  need;                   // MW the scheduled plants must make in each period
+    vector<double>  committedOutput;        // MW the scheduled plants make in each period
+    vector<double>  unserved;               // MW of the need not covered in each period
+    double          fixedOutput = 0.0;      // MW of the plants that are not scheduled
+    double          operatingCost = 0.0;    // Of the scheduled plants over every period
+    double          totalCost = 0.0;        // Operating cost + cost of the demand not covered
+    double          lowerBound = 0.0;       // No schedule has a lower total cost
+    int             iterations = 0;
+    double          seconds = 0.0;          // Time used to solve
+
+    double getSetting(size_t plant, size_t period) const { return settings[plant * periods + period]; }
+};
+
+
+class UnitCommitment {
+private:
+    const PowerGrid&    grid;       // Rated grid the schedule is made for
+    WorkStealingPool&   pool;
+
+    // A scheduled plant.  Setting s (0 to states-1) makes s * stepOutput MW.
+    struct CommitUnit {
+        size_t  slot;               // Position in getPlants()
+        bool    nuclear;
+        double  cost;               // Operating cost per MW
+        double  stepOutput;
+        int     states;
+        int     ramp;               // Most settings moved from one period to the next
+        int     initial;            // Setting in the grid
+    };
+
+    // Work space of the dynamic program (one for each worker)
+    struct UnitWork {
+        vector<double>      value;
+        vector<double>      next;
+        vector<uint16_t>    back;
+        vector<int>         window;
+    };
+
+    vector<CommitUnit>  units;
+    vector<size_t>      meritOrder;     // Units from the cheapest
+    vector<double>      need;
+    double              penalty = 0.0;
+    size_t              periods = 0;
+
+    void   buildUnits(const CommitmentConfig& config, CommitmentSchedule& schedule);
+    template <typename StageCost>
+    double scheduleUnit(const CommitUnit& unit, StageCost stageCost, UnitWork& work, int* pStates) const;
+    double makeFeasible(vector<int>& states, UnitWork& work) const;
+    double scheduleCost(const vector<int>& states, vector<double>* pCommitted) const;
+
+public:
+    // The grid must be rated (adjustPlantsForConditions) and must not change
+    // while the schedule is made
+    UnitCommitment(const PowerGrid& ratedGrid, WorkStealingPool& workers) : grid(ratedGrid), pool(workers) {}
+
+    CommitmentSchedule solve(const CommitmentConfig& config);
+
+    // Sets the throttles and fuel rods of one period of the schedule on the
+    // grid (the grid the schedule was made for, or a branch of it)
+    static void applyPeriod(PowerGrid& scheduleGrid, const CommitmentSchedule& schedule, size_t period);
+};
@@ -0,0 +1,73 @@
+#pragma once
+// File: WorkStealingPool.h
+//
+// Contains the class definition for WorkStealingPool, a fixed set of worker
+// threads that run the iterations of a parallel loop.
+//
+// parallelFor splits the loop into chunks and deals them out to the
+// workers' own queues.  A worker takes chunks from the back of its own queue
+// and, when that is empty, steals from the front of another worker's queue.
+// Workers that finish early keep busy, so uneven iterations (e.g. scenarios
+// that take longer to dispatch) still spread over every core.
+//
+// The body gets the iteration number and the number of the worker running
+// it (0 to size()-1), so it can keep per-worker data without locks.
+//
+// Only one parallelFor runs at a time, and the body must not throw.
+//
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+using namespace std;
+
+class WorkStealingPool {
+public:
+    typedef function<void(size_t, size_t)> LoopBody;     // body(iteration, worker)
+
+private:
+    // Iterations [begin, end) of a loop.  Each chunk points to its loop's body,
+    // so a worker still finishing one loop never runs the next with it.
+    struct Chunk {
+        size_t          begin;
+        size_t          end;
+        const LoopBody* pBody;
+    };
+    struct WorkerQueue {
+        mutex           lock;
+        deque<Chunk>    chunks;
+    };
+
+    vector<thread>                  threads;
+    vector<unique_ptr<WorkerQueue>> queues;         // One for each worker
+
+    // Starting and finishing each loop
+    mutex                   jobLock;
+    condition_variable      jobReady;
+    condition_variable      jobDone;
+    size_t                  generation = 0;         // Counts the loops started
+    atomic<size_t>          chunksLeft{0};
+    bool                    stopping = false;
+
+    void workerLoop(size_t worker);
+    bool takeChunk(size_t worker, Chunk& chunk);
+
+public:
+    // threadCount 0 uses one thread for each core
+    explicit WorkStealingPool(size_t threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Runs body(i, worker) for every i in [0, count) and waits for all of them.
+    // grain is the number of iterations in each chunk (0 picks one).
+    void parallelFor(size_t count, size_t grain, const LoopBody& body);
+
+    size_t size() const { return threads.size(); }
+};
@@ -0,0 +1,172 @@
+// File: AreaQueue.cpp
+//
+// Contains the function definitions for the AreaQueue class (see AreaQueue.h)
+//
+#include <cassert>
+#include "../header/AreaQueue.h"
+
+using namespace std;
+
+//
+// before() - Returns true if area a is served before area b
+//
+bool AreaQueue::before(size_t a, size_t b) const {
+    if (price[a] != price[b])
+        return price[a] > price[b];
+    if (deficit[a] != deficit[b])
+        return deficit[a] > deficit[b];
+    return a < b;
+}
+
+//
+// place() - Stores an area at a heap position
+//
+void AreaQueue::place(size_t pos, size_t area) {
+    heap[pos] = area;
+    heapPos[area] = pos;
+}
+
+void AreaQueue::siftUp(size_t pos) {
+    size_t area = heap[pos];
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (!before(area, heap[parent]))
+            break;
+        place(pos, heap[parent]);
+        pos = parent;
+    }
+    place(pos, area);
+}
+
+void AreaQueue::siftDown(size_t pos) {
+    size_t area = heap[pos];
+    size_t count = heap.size();
+    while (true) {
+        size_t child = 2 * pos + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && before(heap[child + 1], heap[child]))
+            child++;
+        if (!before(heap[child], area))
+            break;
+        place(pos, heap[child]);
+        pos = child;
+    }
+    place(pos, area);
+}
+
+//
+// push() - Adds an area to the heap
+//
+void AreaQueue::push(size_t area) {
+    state[area] = IN_HEAP;
+    heap.push_back(area);
+    heapPos[area] = heap.size() - 1;
+    siftUp(heap.size() - 1);
+}
+
+//
+// remove() - Takes an area out of the heap.  The last entry fills its place.
+//
+void AreaQueue::remove(size_t area) {
+    size_t pos = heapPos[area];
+    size_t last = heap.back();
+    heap.pop_back();
+    state[area] = OUT;
+
+    if (last != area) {
+        place(pos, last);
+        siftUp(pos);
+        siftDown(heapPos[last]);
+    }
+}
+
+
+//
+// build() - Fills the queue with every area that needs power
+//
+void AreaQueue::build(const vector<double>& areaPrices, const vector<double>& areaDeficits, double minimum) {
+    assert(areaPrices.size() == areaDeficits.size());
+
+    price = areaPrices;
+    deficit = areaDeficits;
+    minDeficit = minimum;
+    heapPos.assign(price.size(), 0);
+    state.assign(price.size(), OUT);
+    heap.clear();
+
+    for (size_t area = 0; area < price.size(); area++) {
+        if (deficit[area] > minDeficit) {
+            state[area] = IN_HEAP;
+            heapPos[area] = heap.size();
+            heap.push_back(area);
+        }
+    }
+
+    // Heapify from the last parent down to the root
+    for (size_t pos = heap.size() / 2; pos > 0; pos--)
+        siftDown(pos - 1);
+}
+
+//
+// clear() - Removes every area
+//
+void AreaQueue::clear() {
+    price.clear();
+    deficit.clear();
+    heapPos.clear();
+    state.clear();
+    heap.clear();
+}
+
+
+//
+// update() - Records the new deficit of an area and moves it in the heap.
+//            An area that no longer needs power leaves the heap, and an area
+//            that needs power again is added back.
+//
+void AreaQueue::update(size_t area, double newDeficit) {
+    assert(area < deficit.size());
+
+    double oldDeficit = deficit[area];
+    deficit[area] = newDeficit;
+
+    if (state[area] == IN_HEAP) {
+        if (newDeficit <= minDeficit)
+            remove(area);
+        else if (newDeficit > oldDeficit)
+            siftUp(heapPos[area]);
+        else
+            siftDown(heapPos[area]);
+    }
+    else if (state[area] == OUT && newDeficit > minDeficit) {
+        push(area);
+    }
+    // A held area is put back by release()
+}
+
+
+//
+// pop() - Takes the top area out of the heap and holds it
+//
+size_t AreaQueue::pop() {
+    if (heap.empty())
+        return NO_AREA;
+
+    size_t area = heap[0];
+    remove(area);
+    state[area] = HELD;
+    return area;
+}
+
+//
+// release() - Puts a held area back into the heap if it still needs power
+//
+void AreaQueue::release(size_t area) {
+    if (state[area] != HELD)
+        return;
+
+    state[area] = OUT;
+    if (deficit[area] > minDeficit)
+        push(area);
+}
@@ -0,0 +1,117 @@
+// File: CapacityIndex.cpp
+//
+// Contains the function definitions for the CapacityIndex class (see CapacityIndex.h)
+//
+#include <limits>
+#include <algorithm>
+#include <cassert>
+#include "../header/CapacityIndex.h"
+
+using namespace std;
+
+// Value of the unused leaves past the last slot, never >= any request
+static const double NO_CAPACITY = -numeric_limits<double>::infinity();
+
+
+//
+// build() - Fills the leaves with the capacity of each slot and computes
+//           the maximum of every node from the bottom up
+//
+void CapacityIndex::build(const vector<double>& capacities) {
+    slotCount = capacities.size();
+    leafCount = 1;
+    while (leafCount < slotCount)
+        leafCount *= 2;
+
+    tree.assign(2 * leafCount, NO_CAPACITY);
+    copy(capacities.begin(), capacities.end(), tree.begin() + leafCount);
+    for (size_t node = leafCount - 1; node > 0; node--)
+        tree[node] = max(tree[2 * node], tree[2 * node + 1]);
+
+    bySize.clear();
+    if (bestFitEnabled) {
+        for (size_t slot = 0; slot < slotCount; slot++)
+            bySize.emplace(capacities[slot], slot);
+    }
+}
+
+
+//
+// clear() - Removes every slot
+//
+void CapacityIndex::clear() {
+    slotCount = 0;
+    leafCount = 0;
+    tree.clear();
+    bySize.clear();
+}
+
+
+//
+// enableBestFit() - Turns the ordered set used by bestFit() on or off
+//
+void CapacityIndex::enableBestFit(bool enable) {
+    bestFitEnabled = enable;
+    bySize.clear();
+    if (enable) {
+        for (size_t slot = 0; slot < slotCount; slot++)
+            bySize.emplace(getCapacity(slot), slot);
+    }
+}
+
+
+//
+// update() - Sets the capacity of a slot and fixes the maximum of each node
+//            on the path to the root
+//
+void CapacityIndex::update(size_t slot, double capacity) {
+    assert(slot < slotCount);
+
+    size_t node = leafCount + slot;
+    if (bestFitEnabled) {
+        bySize.erase(make_pair(tree[node], slot));
+        bySize.emplace(capacity, slot);
+    }
+
+    tree[node] = capacity;
+    for (node /= 2; node > 0; node /= 2) {
+        double largest = max(tree[2 * node], tree[2 * node + 1]);
+        if (tree[node] == largest)
+            break;          // The rest of the path is already correct
+        tree[node] = largest;
+    }
+}
+
+
+//
+// firstAtLeast() - Walks down from the root, going left whenever the left
+//                  child has enough capacity
+//
+size_t CapacityIndex::firstAtLeast(double amount) const {
+    if (slotCount == 0 || !(tree[1] >= amount))
+        return NO_SLOT;
+
+    size_t node = 1;
+    while (node < leafCount)
+        node = (tree[2 * node] >= amount) ? 2 * node : 2 * node + 1;
+    return node - leafCount;
+}
+
+
+//
+// bestFit() - Returns the slot with the least capacity that covers the amount
+//
+size_t CapacityIndex::bestFit(double amount) const {
+    if (bestFitEnabled) {
+        auto it = bySize.lower_bound(make_pair(amount, size_t(0)));
+        return it == bySize.end() ? NO_SLOT : it->second;
+    }
+
+    size_t best = NO_SLOT;
+    for (size_t slot = 0; slot < slotCount; slot++) {
+        double capacity = getCapacity(slot);
+        if (capacity >= amount && (best == NO_SLOT || capacity < getCapacity(best)))
+            best = slot;
+    }
+    return best;
+}
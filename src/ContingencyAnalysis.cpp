@@ -0,0 +1,107 @@
+// File: ContingencyAnalysis.cpp
+//
+// Contains the function definitions for the N-1 contingency analysis (see
+// ContingencyAnalysis.h)
+//
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include "../header/ContingencyAnalysis.h"
+
+using namespace std;
+
+//
+// percentMet() - Returns the percent of demand met, as in generateUsageReport
+//
+double ContingencyAnalysis::percentMet(const PowerGrid& scenarioGrid) {
+    double required = scenarioGrid.getTotalPowerRequired();
+    if (required <= 0.0)
+        return 100.0;
+    return scenarioGrid.getTotalPowerSupplied() / required * 100;
+}
+
+
+//
+// runContingency() - Restores the grid, takes the asset out of service (none
+//          for the base case), and runs the distribution.  Returns the
+//          percent of demand met.
+//
+double ContingencyAnalysis::runContingency(PowerGrid& scenarioGrid, const ContingencyResult* pOutage) {
+    scenarioGrid.restoreBaseline();
+
+    if (pOutage != nullptr && pOutage->type == ASSET_PLANT) {
+        scenarioGrid.writablePlant(pOutage->index)->setOnline(false);
+        scenarioGrid.adjustPlantsForConditions();
+    }
+    else if (pOutage != nullptr) {
+        scenarioGrid.derateLine(pOutage->index, 0.0);
+    }
+
+    scenarioGrid.distributePower(60);
+    for (int pass = 0; pass < 4; pass++)
+        scenarioGrid.distributePower(10);
+
+    return percentMet(scenarioGrid);
+}
+
+
+//
+// run() - Runs the base case, then every outage of a plant or line the base
+//         case draws on, on the pool's workers.  Each worker makes a branch
+//         of the grid the first time it runs one.  The outages are ranked by
+//         the drop in demand met.
+//
+//         The plant and line selections only ever pick an asset that has
+//         the capacity asked for, so taking out an asset the base case never
+//         picked (see getDispatchedAssets) leaves every choice the same.
+//         Those outages are not run, and meet the same demand as the base case.
+//
+ContingencyResults ContingencyAnalysis::run() {
+    ContingencyResults results;
+    auto start = chrono::steady_clock::now();
+
+    unique_ptr<PowerGrid> pBase = grid.branch();
+    pBase->setVerbose(false);
+    pBase->saveBaseline();
+    results.basePercentMet = runContingency(*pBase, nullptr);
+
+    vector<uint8_t> plantUsed, lineUsed;
+    pBase->getDispatchedAssets(plantUsed, lineUsed);
+    pBase.reset();
+
+    vector<size_t> toRun;       // Outages of assets the base case picked
+    results.outages.reserve(plantUsed.size() + lineUsed.size());
+    for (size_t i = 0; i < plantUsed.size(); i++) {
+        if (plantUsed[i])
+            toRun.push_back(results.outages.size());
+        results.outages.push_back({ ASSET_PLANT, i, results.basePercentMet, 0.0 });
+    }
+    for (size_t i = 0; i < lineUsed.size(); i++) {
+        if (lineUsed[i])
+            toRun.push_back(results.outages.size());
+        results.outages.push_back({ ASSET_LINE, i, results.basePercentMet, 0.0 });
+    }
+
+    vector<unique_ptr<PowerGrid>> branches(pool.size());
+    pool.parallelFor(toRun.size(), 0, [&](size_t i, size_t worker) {
+        unique_ptr<PowerGrid>& pBranch = branches[worker];
+        if (!pBranch) {
+            pBranch = grid.branch();
+            pBranch->setVerbose(false);
+            pBranch->saveBaseline();
+        }
+        ContingencyResult& outage = results.outages[toRun[i]];
+        outage.percentMet = runContingency(*pBranch, &outage);
+    });
+
+    for (auto& outage : results.outages)
+        outage.drop = results.basePercentMet - outage.percentMet;
+
+    // Equal drops stay in plant then line order
+    stable_sort(results.outages.begin(), results.outages.end(),
+        [](const ContingencyResult& a, const ContingencyResult& b) { return a.drop > b.drop; });
+
+    auto stop = chrono::steady_clock::now();
+    results.seconds = chrono::duration<double>(stop - start).count();
+    return results;
+}
@@ -35,31 +35,55 @@ using namespace std;
 void PowerGrid::distributePower(int areaPercentage) {
 
     // Print status message
-    cout << endl << "Distributing power based on " << areaPercentage << "% allocation." << endl;
+    if (verbose)
+        cout << endl << "Distributing power based on " << areaPercentage << "% allocation." << endl;
 
     // Setup inital conditions in control variable in PowerGrid object
     plantsHaveCapacity = 1;
     linesHaveCapacity = 1;
     
+    // Serve the areas with the highest price first.  Each area is taken out of
+    // the queue once per pass and put back at the end if it still needs power.
+    if (areaSchedule == AREA_PRICE_PRIORITY) {
+        if (areaQueueStale)
+            rebuildAreaQueue();
+
+        vector<size_t> served;
+        for (size_t i = areaQueue.pop(); i != AreaQueue::NO_AREA; i = areaQueue.pop()) {
+            served.push_back(i);
+            serveArea(areas[i], areaPercentage);
+        }
+        for (size_t i : served)
+            areaQueue.release(i);
+        return;
+    }
+
     // Loop through each service area and check if it needs power
     for (auto& area : areas) {
+        serveArea(area, areaPercentage);
+    } // for
 
-        // Check if this location requires more power and allocate power to it
-        if (area.getPowerDeficit() > FP_ROUND(0)) {
+}
 
-            // The amount of power to request for this area is either the 
-            // requested percent of its needs or the amount to fulfill 
-            // its total power needs,(i.e  powerDeficit), whichever is smaller 
-            double percentOfRequested = area.getPowerRequired() * areaPercentage / 100.0;
-            double deficit = area.getPowerDeficit();
-            double power = min(percentOfRequested, deficit);
 
-            // Try to find and deliver power for the area
-            allocatePowerToArea(area, power);
-        }
+//
+// serveArea(): Requests a percent of an area's power needs if it still requires power
+//
+void PowerGrid::serveArea(ServiceArea& area, int areaPercentage) {
 
-    } // for
+    // Check if this location requires more power and allocate power to it
+    if (area.getPowerDeficit() > FP_ROUND(0)) {
 
+        // The amount of power to request for this area is either the 
+        // requested percent of its needs or the amount to fulfill 
+        // its total power needs,(i.e  powerDeficit), whichever is smaller 
+        double percentOfRequested = area.getPowerRequired() * areaPercentage / 100.0;
+        double deficit = area.getPowerDeficit();
+        double power = min(percentOfRequested, deficit);
+
+        // Try to find and deliver power for the area
+        allocatePowerToArea(area, power);
+    }
 }
 
 
@@ -73,26 +97,26 @@ void PowerGrid::distributePower(int areaPercentage) {
 void PowerGrid::allocatePowerToArea(ServiceArea &area, double powerRequested) {
 
     // Display initial request.
-    cout << std::setw(12) << std::left << area.getAreaName()
-         << " is requesting " 
-         << std::right << std::setprecision(2)<< std::setw(6) << powerRequested << " mw.  ";
+    if (verbose)
+        cout << std::setw(12) << std::left << area.getAreaName(*names)
+             << " is requesting " 
+             << std::right << std::setprecision(2)<< std::setw(6) << powerRequested << " mw.  ";
 
  
     // Find the transmission line to use, In Assgin-2 we search the lines in the order
     // provided and use the first one that has the capacity to carry the power need.
-    TransmissionLine* pCurLine = NULL;
-
-    for (auto& line : transmissionLines) {
-        if (line.getRemainingCapacity() >= powerRequested) {
-            pCurLine = &line; // Found a line with capacity
-            break;
-        }
-    }
+    // The line capacity index finds that line without scanning (see findLineForPower).
+    TransmissionLine* pCurLine = findLineForPower(powerRequested);
 
     // Check if no line has any avaialble capacity
+    if (pCurLine == NULL && splitAllocations) {
+        allocateInFragments(area, powerRequested);     // Try several smaller lines
+        return;
+    }
     if (pCurLine == NULL) {
         linesHaveCapacity = false;     // Set flag that no plants have capacity
-        cout << "No Lines have capacity" << endl;
+        if (verbose)
+            cout << "No Lines have capacity" << endl;
         return;
     }
 
@@ -101,34 +125,174 @@ void PowerGrid::allocatePowerToArea(ServiceArea &area, double powerRequested) {
     double plantPowerRequested = powerRequested * pCurLine->getEfficiency();
 
     // Search the plants to find the first plant that has enough power to provide
-    PowerPlant* pCurPlant = NULL;
-    for (auto& plant : plants) {
-        if (plant->getAvailableCapacity() >= plantPowerRequested) {
-            pCurPlant = plant; // Found a plant with capacity
-            break;
-        }
-    }
+    // (for merit order dispatch, the cheapest plant that has enough power)
+    PowerPlant* pCurPlant = findPlantForPower(plantPowerRequested);
 
     // Check if no power plants had any avaialble capacity
+    if (pCurPlant == NULL && splitAllocations) {
+        allocateInFragments(area, powerRequested);     // Try several smaller plants
+        return;
+    }
     if (pCurPlant == NULL) {
         plantsHaveCapacity = 0;     // Set flag that no plants have capacity
-        cout << "No Plants have capacity" << endl;
+        if (verbose)
+            cout << "No Plants have capacity" << endl;
         return;
     }
 
 
     // We located a line and plant - allocate to power to the area and adjust levels
-    cout << "Allocating: "
-        << setprecision(2) << setw(6) << right << plantPowerRequested
-        << " mw from " << setw(17) << left << pCurPlant->getName()
-        << " On: " << pCurLine->getLineID()
-        << ", " << pCurLine->getLineName()
-        << endl;
+    if (verbose)
+        cout << "Allocating: "
+            << setprecision(2) << setw(6) << right << plantPowerRequested
+            << " mw from " << setw(17) << left << pCurPlant->getName(*names)
+            << " On: " << pCurLine->getLineID()
+            << ", " << pCurLine->getLineName(*names)
+            << endl;
 
 
     // Allocate the power to the area by adjusting the plant, area, and line capacities
+    double plantAvailable = pCurPlant->getAvailableCapacity();
     area.addCapacity(plantPowerRequested);                   // Add the power capacity to the area
     pCurPlant->reduceCapacity(powerRequested);    // Reduce the plant's avaiable capacity
     pCurLine->reduceCapacity(plantPowerRequested);           // Reduce the avaiable capacity of the line
+
+    recordAllocation(area, pCurPlant, pCurLine, powerRequested,
+                     plantAvailable - pCurPlant->getAvailableCapacity(), plantPowerRequested);
 }
 
+
+//
+//  allocateInFragments()
+//
+// Fills a request that no single line and plant can carry from several
+// (plant, line) pairs.  Each fragment is the largest piece that can be
+// sent: the capacity indexes give the most any one line or plant has left,
+// so a fragment never needs a rescan of the lines or plants.  At most
+// MAX_ALLOC_FRAGMENTS are used for one request.
+//
+// Each fragment is accounted for the same way as a whole request: the plant
+// provides the fragment, and the area and line receive the fragment times
+// the line efficiency.
+//
+void PowerGrid::allocateInFragments(ServiceArea& area, double powerRequested) {
+    if (lineIndexStale)
+        rebuildLineIndex();
+    if (plantIndexStale)
+        rebuildPlantIndex();
+
+    double remaining = powerRequested;
+    int    fragments = 0;
+    const char* pStopReason = "";       // Why no more fragments could be sent
+
+    while (fragments < MAX_ALLOC_FRAGMENTS && remaining > FP_ROUND(0)) {
+
+        // The largest piece any line can carry, then the largest piece any plant can provide
+        double linePower = min(remaining, lineIndex.getMaxCapacity());
+        if (linePower <= FP_ROUND(0)) {
+            linesHaveCapacity = false;
+            pStopReason = "No Lines have capacity";
+            break;
+        }
+        double piece = min(linePower, plantIndex.getMaxCapacity());
+        if (piece <= FP_ROUND(0)) {
+            plantsHaveCapacity = 0;
+            pStopReason = "No Plants have capacity";
+            break;
+        }
+
+        TransmissionLine* pLine = findLineForPower(piece);
+        PowerPlant* pPlant = findPlantForPower(piece);
+        double delivered = piece * pLine->getEfficiency();
+
+        if (verbose)
+            cout << (fragments == 0 ? "" : "\n" + string(39, ' ')) << "Splitting:  "
+                << setprecision(2) << setw(6) << right << delivered
+                << " mw from " << setw(17) << left << pPlant->getName(*names)
+                << " On: " << pLine->getLineID()
+                << ", " << pLine->getLineName(*names);
+
+        double plantAvailable = pPlant->getAvailableCapacity();
+        area.addCapacity(delivered);
+        pPlant->reduceCapacity(piece);
+        pLine->reduceCapacity(delivered);
+        recordAllocation(area, pPlant, pLine, piece, plantAvailable - pPlant->getAvailableCapacity(), delivered);
+
+        remaining -= piece;
+        fragments++;
+    }
+
+    if (verbose) {
+        if (fragments == 0)
+            cout << pStopReason;
+        cout << endl;
+    }
+}
+
+
+//
+//  recordAllocation()
+//
+// Adds an allocation to the ledger so it can be released if the plant,
+// line, or area changes (see Redispatch.cpp).  drawn is what was taken from
+// the plant, which can be less than requested.
+//
+void PowerGrid::recordAllocation(ServiceArea& area, PowerPlant* pPlant, TransmissionLine* pLine,
+                                 double requested, double drawn, double delivered) {
+    if (lineAllocations.size() < transmissionLines.size())
+        lineAllocations.resize(transmissionLines.size(), NO_ALLOCATION);
+    if (areaAllocations.size() < areas.size())
+        areaAllocations.resize(areas.size(), NO_ALLOCATION);
+
+    size_t slot = pPlant->getGridSlot();
+    size_t areaSlot = size_t(&area - areas.data());
+    size_t lineSlot = size_t(pLine - transmissionLines.data());
+    allocations.push_back({ slot, areaSlot, lineSlot, requested, drawn, delivered,
+                            plantAllocations[slot], lineAllocations[lineSlot], areaAllocations[areaSlot], true });
+
+    size_t newest = allocations.size() - 1;
+    plantAllocations[slot] = newest;
+    lineAllocations[lineSlot] = newest;
+    areaAllocations[areaSlot] = newest;
+}
+
+
+//
+//  findLineForPower()
+//
+// Returns the line to carry a request, or NULL if no line has the capacity.
+// The index of remaining line capacity gives the same line as scanning the
+// lines in order (first fit) in O(log n), or the line with the least
+// capacity that is still enough (best fit).
+//
+TransmissionLine* PowerGrid::findLineForPower(double powerRequested) {
+    if (lineIndexStale)
+        rebuildLineIndex();
+
+    size_t slot = (lineSelection == LINE_BEST_FIT) ? lineIndex.bestFit(powerRequested)
+                                                   : lineIndex.firstAtLeast(powerRequested);
+    if (slot == CapacityIndex::NO_SLOT)
+        return NULL;
+    return &transmissionLines[slot];
+}
+
+
+//
+//  findPlantForPower()
+//
+// Returns the first plant (in the order of the plant vector) with enough
+// available capacity, or NULL if there is none.  The index of available
+// plant capacity gives the same plant as scanning the plants in O(log n).
+// For merit order dispatch the slots of the index are in order of operating
+// cost, so the same search returns the cheapest plant with enough capacity.
+// In a branch, a shared plant is copied before it is returned.
+//
+PowerPlant* PowerGrid::findPlantForPower(double plantPowerRequested) {
+    if (plantIndexStale)
+        rebuildPlantIndex();
+
+    size_t slot = plantIndex.firstAtLeast(plantPowerRequested);
+    if (slot == CapacityIndex::NO_SLOT)
+        return NULL;
+    return ownPlant(plantIndexOrder[slot]);     // The caller allocates from the plant
+}
@@ -0,0 +1,290 @@
+// File: EventSimulator.cpp
+//
+// Contains the function definitions for the discrete event simulation (see
+// EventSimulator.h)
+//
+#include <iostream>
+#include <fstream>
+#include <unordered_map>
+#include <algorithm>
+#include "../header/EventSimulator.h"
+#include "../header/GridFile.h"
+
+using namespace std;
+
+// Names of the events in the event file and the log
+static const struct {
+    string_view     name;
+    GridEventType   type;
+} EVENT_NAMES[] = {
+    { "trip",    EVENT_PLANT_TRIP },
+    { "restore", EVENT_PLANT_RESTORE },
+    { "rods",    EVENT_FUEL_RODS },
+    { "derate",  EVENT_LINE_DERATE },
+    { "demand",  EVENT_DEMAND },
+};
+
+
+//
+// schedule() - Adds an event to the queue
+//
+void EventSimulator::schedule(const GridEvent& event) {
+    eventQueue.push({ event, nextSequence++, NOT_AN_UNDO });
+}
+
+
+//
+// percentMet() - Returns the percent of demand met, as in generateUsageReport
+//
+double EventSimulator::percentMet() const {
+    double required = grid.getTotalPowerRequired();
+    if (required <= 0.0)
+        return 100.0;
+    return grid.getTotalPowerSupplied() / required * 100;
+}
+
+
+//
+// advanceTo() - Adds the energy required and served from the clock to the
+//               given time (the grid does not change in between)
+//
+void EventSimulator::advanceTo(double time) {
+    if (time <= clock)
+        return;
+
+    double hours = time - clock;
+    stats.energyRequired += grid.getTotalPowerRequired() * hours;
+    stats.energyServed += grid.getTotalPowerSupplied() * hours;
+    stats.hours += hours;
+    clock = time;
+}
+
+
+//
+// currentValue() - Returns the value an event of the held key would change:
+//                  1 or 0 for a plant online or offline, the fuel rods, the
+//                  line fraction, or the area demand
+//
+double EventSimulator::currentValue(const HeldKey& key) const {
+    switch (key.first) {
+    case EVENT_FUEL_RODS:
+        return static_cast<const NuclearPlant*>(grid.getPlants()[key.second])->getFuelRods();
+    case EVENT_LINE_DERATE:
+        return grid.getTransmissionLines()[key.second].getUsableFraction();
+    case EVENT_DEMAND:
+        return grid.getAreas()[key.second].getPowerRequired();
+    default:
+        return grid.getPlants()[key.second]->isOnline() ? 1.0 : 0.0;
+    }
+}
+
+
+//
+// applyEvent() - Works out the value an event leaves its plant, line, or
+//                area at (see the holds in EventSimulator.h), makes the
+//                change, and moves the power it affects.  Returns false if
+//                the event did not change the grid.
+//
+bool EventSimulator::applyEvent(QueuedEvent& queued) {
+    GridEvent& event = queued.event;
+    bool plantEvent = event.type == EVENT_PLANT_TRIP || event.type == EVENT_PLANT_RESTORE;
+    HeldKey key(plantEvent ? EVENT_PLANT_TRIP : event.type, event.index);
+
+    double current = currentValue(key);
+    double value = plantEvent ? (event.type == EVENT_PLANT_RESTORE ? 1.0 : 0.0)
+                 : event.type == EVENT_FUEL_RODS ? (int)event.value
+                 : event.type == EVENT_LINE_DERATE ? clamp(event.value, 0.0, 1.0)
+                 : event.value;
+
+    auto held = heldValues.find(key);
+    if (queued.undoOf != NOT_AN_UNDO) {
+        // The end of a hold: go back to the latest hold left, or the value
+        // before the holds.  An event without a duration may have dropped it.
+        if (held == heldValues.end())
+            return false;
+        vector<pair<size_t, double>>& holds = held->second.holds;
+        auto hold = find_if(holds.begin(), holds.end(), [&queued](const pair<size_t, double>& h) {
+            return h.first == queued.undoOf;
+        });
+        if (hold == holds.end())
+            return false;
+        holds.erase(hold);
+        value = holds.empty() ? held->second.before : holds.back().second;
+        if (holds.empty())
+            heldValues.erase(held);
+    }
+    else if (event.duration > 0.0) {
+        if (held == heldValues.end()) {
+            if (value == current)
+                return false;
+            held = heldValues.emplace(key, Held{ current, {} }).first;
+        }
+        held->second.holds.emplace_back(queued.sequence, value);
+
+        GridEvent undo = event;
+        undo.time = event.time + event.duration;
+        undo.duration = 0.0;
+        eventQueue.push({ undo, nextSequence++, queued.sequence });
+    }
+    else if (held != heldValues.end())
+        heldValues.erase(held);
+
+    if (value == current)
+        return false;
+
+    // The log shows the change that was made
+    if (plantEvent)
+        event.type = value > 0.0 ? EVENT_PLANT_RESTORE : EVENT_PLANT_TRIP;
+    else
+        event.value = value;
+
+    vector<size_t> moved;       // Areas whose allocations the event moved
+    bool freed = false;         // The event gives back plant or line capacity
+
+    switch (key.first) {
+    case EVENT_FUEL_RODS:
+        freed = value > current;
+        static_cast<NuclearPlant*>(grid.writablePlant(event.index))->setFuelRods((int)value);
+        grid.redispatchDirtyPlants(&moved);
+        break;
+    case EVENT_LINE_DERATE:
+        freed = value > current;
+        grid.derateLine(event.index, value);
+        grid.redispatchLine(event.index, &moved);
+        break;
+    case EVENT_DEMAND:
+        freed = value < current;
+        grid.setAreaDemand(event.index, value);
+        grid.redispatchArea(event.index);
+        moved.push_back(event.index);
+        break;
+    default:
+        freed = value > 0.0;
+        grid.writablePlant(event.index)->setOnline(freed);
+        grid.redispatchDirtyPlants(&moved);
+        break;
+    }
+
+    // Remember the areas the event touched, then give the capacity that came
+    // back to the areas events have left short (no other area is touched)
+    shortAreas.insert(shortAreas.end(), moved.begin(), moved.end());
+    sort(shortAreas.begin(), shortAreas.end());
+    shortAreas.erase(unique(shortAreas.begin(), shortAreas.end()), shortAreas.end());
+    if (freed)
+        grid.serveAreas(shortAreas);
+
+    const vector<ServiceArea>& areas = grid.getAreas();
+    shortAreas.erase(remove_if(shortAreas.begin(), shortAreas.end(), [&areas](size_t i) {
+        return areas[i].getPowerRequired() - areas[i].getPowerProvided() <= FP_ROUND(0);
+    }), shortAreas.end());
+    return true;
+}
+
+
+//
+// run() - Runs the events in time order up to endTime
+//
+size_t EventSimulator::run(double endTime, ostream* pLog) {
+    size_t count = 0;
+    while (!eventQueue.empty() && eventQueue.top().event.time <= endTime) {
+        QueuedEvent queued = eventQueue.top();
+        eventQueue.pop();
+
+        advanceTo(queued.event.time);
+        if (!applyEvent(queued))
+            continue;
+        count++;
+        const GridEvent& event = queued.event;
+
+        double met = percentMet();
+        if (met < stats.lowestPercentMet) {
+            stats.lowestPercentMet = met;
+            stats.lowestTime = clock;
+        }
+
+        if (pLog != nullptr) {
+            string_view name = event.type == EVENT_LINE_DERATE ? grid.getTransmissionLines()[event.index].getLineName(grid.getNames())
+                             : event.type == EVENT_DEMAND ? grid.getAreas()[event.index].getAreaName(grid.getNames())
+                             : grid.getPlants()[event.index]->getName(grid.getNames());
+            *pLog << event.time << ',' << EVENT_NAMES[event.type].name << ',' << name << ','
+                << event.value << ',' << grid.getTotalPowerSupplied() << ',' << met << '\n';
+        }
+    }
+
+    advanceTo(endTime);
+    stats.events += count;
+    return count;
+}
+
+
+//
+// readEvents() - Reads the events of an event file into the queue.
+//                Returns 0 on success.
+//
+int EventSimulator::readEvents(const string& filename) {
+    ifstream input(filename);
+    if (!input) {
+        cerr << "Error: Unable to open event file " << filename << endl;
+        return -1;
+    }
+
+    // Find the plants, lines, and areas by the NameID of their names (the first with a name wins)
+    unordered_map<NameID, size_t> plantsByName, linesByName, areasByName;
+    const vector<PowerPlant*>& plants = grid.getPlants();
+    for (size_t i = plants.size(); i-- > 0; )
+        plantsByName[plants[i]->getNameID()] = i;
+
+    const vector<TransmissionLine>& lines = grid.getTransmissionLines();
+    for (size_t i = lines.size(); i-- > 0; )
+        linesByName[lines[i].getLineNameID()] = i;
+    const vector<ServiceArea>& areas = grid.getAreas();
+    for (size_t i = areas.size(); i-- > 0; )
+        areasByName[areas[i].getAreaNameID()] = i;
+
+    string line;
+    size_t lineNumber = 0;
+    while (getline(input, line)) {
+        lineNumber++;
+        string_view rest = line;
+        string_view timeField = TextScanner::splitField(rest, ',');
+        if (timeField.empty() || timeField[0] == '#')
+            continue;
+
+        string_view eventName = TextScanner::splitField(rest, ',');
+        string_view name = TextScanner::splitField(rest, ',');
+        string_view valueField = TextScanner::splitField(rest, ',');
+        string_view durationField = TextScanner::splitField(rest, ',');
+
+        GridEvent event;
+        bool valid = TextScanner::parseDouble(timeField, event.time)
+            && (valueField.empty() || TextScanner::parseDouble(valueField, event.value))
+            && (durationField.empty() || TextScanner::parseDouble(durationField, event.duration));
+
+        bool knownEvent = false;
+        for (const auto& entry : EVENT_NAMES) {
+            if (entry.name == eventName) {
+                event.type = entry.type;
+                knownEvent = true;
+            }
+        }
+
+        // The event must name a plant (of the right type), line, or area of the grid
+        NameID id;
+        bool found = grid.getNames().find(name, id);
+        unordered_map<NameID, size_t>& byName = event.type == EVENT_LINE_DERATE ? linesByName
+                                              : event.type == EVENT_DEMAND ? areasByName : plantsByName;
+        auto item = found ? byName.find(id) : byName.end();
+        if (item != byName.end()) {
+            event.index = item->second;
+            if (event.type == EVENT_FUEL_RODS && plants[event.index]->getPlantType() != PlantType::Nuclear)
+                item = byName.end();
+        }
+
+        if (!valid || !knownEvent || item == byName.end()) {
+            cerr << "Error: Bad event on line " << lineNumber << " of event file " << filename << endl;
+            return -1;
+        }
+        schedule(event);
+    }
+    return 0;
+}
@@ -0,0 +1,213 @@
+// File: FlowDispatch.cpp
+//
+// Contains the functions of the PowerGrid class for the minimum cost flow
+// dispatch, an alternative to the greedy rounds of distributePower.
+//
+// The grid is modeled as a flow network with gains (see MinCostFlow.h).
+// Flow is MW drawn from the plants until it crosses a line, and MW delivered
+// after that:
+//
+//      source -> hub -> delivery -> sink
+//
+//  - source -> hub:        the plants: capacity = available capacity,
+//                          cost = operating cost
+//  - hub -> delivery:      the lines: capacity = remaining capacity /
+//                          efficiency (the MW drawn that fill the line),
+//                          gain = efficiency (the MW delivered per MW drawn)
+//  - delivery -> sink:     the areas: capacity = unmet demand (MW delivered),
+//                          cost = -MW price, the revenue of the power delivered
+//
+// Every plant can reach every line and every line can reach every area, so
+// one hub node and one delivery node are enough.  Plants with the same
+// operating cost, lines with the same efficiency, and areas with the same MW
+// price would be parallel arcs that differ only in capacity, so each such
+// group is one arc.  That does not change the answer, and it keeps the
+// network small when many plants, lines, or areas are alike.  Without any
+// groups the network has one arc for each plant, line, and area.
+//
+// With FLOW_MAX_PROFIT the solver sends flow only where revenue is more than
+// cost.  With FLOW_MAX_DELIVERY every delivered MW is also given a large
+// value.  That gives the most power delivered, and the most profit among
+// the dispatches that deliver the most.
+//
+// The flow of each group is shared out in file order.  The power of each
+// line is then matched with the areas and the plants in that order.  Each
+// (plant, line, area) piece is written into the plants, lines, and areas
+// and recorded in the allocation ledger the same way distributePower does,
+// so the usual reports work and the re-dispatch functions can move it.
+//
+#include <map>
+#include <algorithm>
+#include "../header/PowerGrid.h"
+#include "../header/MinCostFlow.h"
+
+using namespace std;
+
+
+// Unmet demand of an area (0 if the area has all the power it needs)
+static double unmetDemand(const ServiceArea& area) {
+    return max(0.0, area.getPowerRequired() - area.getPowerProvided());
+}
+
+// Part of the flow of a group given to one plant, line, or area
+struct FlowShare {
+    size_t  index;          // Index in plants, transmissionLines, or areas
+    double  amount;         // MW drawn for a plant, MW delivered for a line or an area
+};
+
+
+//
+// optimizeDispatch():  Dispatches the plants to the areas with a minimum cost
+//                  flow.  Returns the MW delivered to the areas.
+//
+double PowerGrid::optimizeDispatch(FlowObjective objective) {
+
+    // Group the plants, lines, and areas that still have capacity or need power
+    map<double, vector<size_t>> plantGroups;    // By operating cost
+    map<double, vector<size_t>> lineGroups;     // By efficiency
+    map<double, vector<size_t>> areaGroups;     // By MW price
+
+    for (size_t i = 0; i < plants.size(); i++) {
+        if (plants[i]->getAvailableCapacity() > MinCostFlow::EPSILON)
+            plantGroups[plants[i]->getOperatingCost()].push_back(i);
+    }
+    for (size_t l = 0; l < transmissionLines.size(); l++) {
+        const TransmissionLine& line = transmissionLines[l];
+        if (line.getRemainingCapacity() > MinCostFlow::EPSILON && line.getEfficiency() > 0.0)
+            lineGroups[line.getEfficiency()].push_back(l);
+    }
+    for (size_t j = 0; j < areas.size(); j++) {
+        if (unmetDemand(areas[j]) > FP_ROUND(0))
+            areaGroups[areas[j].getMWPrice()].push_back(j);
+    }
+
+    double totalDelivered = 0.0;
+    int    pivots = 0;
+
+    if (!plantGroups.empty() && !lineGroups.empty() && !areaGroups.empty()) {
+
+        // Value given to each delivered MW so the most power is delivered
+        double deliveryValue = 0.0;
+        if (objective == FLOW_MAX_DELIVERY) {
+            double minEfficiency = lineGroups.begin()->first;
+            double largest = plantGroups.rbegin()->first / minEfficiency + areaGroups.rbegin()->first;
+            deliveryValue = 100.0 * max(largest, 1.0);
+        }
+
+        // Build the network and solve it
+        MinCostFlow network;
+        int source = network.addNode();
+        int sink = network.addNode();
+        int hub = network.addNode();
+        int delivery = network.addNode();
+
+        vector<int> plantArcs, lineArcs, areaArcs;
+        for (const auto& group : plantGroups) {
+            double available = 0.0;
+            for (size_t i : group.second)
+                available += plants[i]->getAvailableCapacity();
+            plantArcs.push_back(network.addArc(source, hub, available, group.first));
+        }
+        for (const auto& group : lineGroups) {
+            double gross = 0.0;
+            for (size_t l : group.second)
+                gross += transmissionLines[l].getRemainingCapacity() / group.first;
+            lineArcs.push_back(network.addArc(hub, delivery, gross, 0.0, group.first));
+        }
+        for (const auto& group : areaGroups) {
+            double demand = 0.0;
+            for (size_t j : group.second)
+                demand += unmetDemand(areas[j]);
+            areaArcs.push_back(network.addArc(delivery, sink, demand, -(group.first + deliveryValue)));
+        }
+
+        double drawn = 0.0;
+        network.solve(source, sink, drawn);
+        pivots = network.getPivots();
+
+        // Share the flow of each group in file order
+        vector<FlowShare> plantShares, lineShares, areaShares;
+        size_t g = 0;
+        for (const auto& group : plantGroups) {
+            double flow = network.getFlow(plantArcs[g++]);
+            for (size_t i : group.second) {
+                double amount = min(flow, plants[i]->getAvailableCapacity());
+                if (amount > MinCostFlow::EPSILON) {
+                    plantShares.push_back({ i, amount });
+                    flow -= amount;
+                }
+            }
+        }
+        g = 0;
+        for (const auto& group : lineGroups) {
+            double flow = network.getFlow(lineArcs[g++]) * group.first;
+            for (size_t l : group.second) {
+                double amount = min(flow, transmissionLines[l].getRemainingCapacity());
+                if (amount > MinCostFlow::EPSILON) {
+                    lineShares.push_back({ l, amount });
+                    flow -= amount;
+                }
+            }
+        }
+        g = 0;
+        for (const auto& group : areaGroups) {
+            double flow = network.getFlow(areaArcs[g++]);
+            for (size_t j : group.second) {
+                double amount = min(flow, unmetDemand(areas[j]));
+                if (amount > MinCostFlow::EPSILON) {
+                    areaShares.push_back({ j, amount });
+                    flow -= amount;
+                }
+            }
+        }
+
+        // Match the power of each line with the areas and the plants in
+        // order.  Each piece takes all that is left of the line, the area,
+        // or the plant, so there are fewer pieces than plants, lines, and
+        // areas together.
+        size_t p = 0;
+        size_t a = 0;
+        for (FlowShare& lineShare : lineShares) {
+            TransmissionLine& line = transmissionLines[lineShare.index];
+            double efficiency = line.getEfficiency();
+
+            while (lineShare.amount > MinCostFlow::EPSILON && p < plantShares.size() && a < areaShares.size()) {
+                FlowShare& plantShare = plantShares[p];
+                FlowShare& areaShare = areaShares[a];
+                double delivered = min({ lineShare.amount, areaShare.amount, plantShare.amount * efficiency });
+                double piece = delivered / efficiency;
+
+                lineShare.amount -= delivered;
+                areaShare.amount -= delivered;
+                plantShare.amount -= piece;
+                if (areaShare.amount <= MinCostFlow::EPSILON)
+                    a++;
+                if (plantShare.amount <= MinCostFlow::EPSILON)
+                    p++;
+
+                // Rounding must not take more than the plant or line has left
+                PowerPlant* pPlant = writablePlant(plantShare.index);
+                double plantAvailable = pPlant->getAvailableCapacity();
+                piece = min(piece, plantAvailable);
+                delivered = min(piece * efficiency, line.getRemainingCapacity());
+                if (delivered <= MinCostFlow::EPSILON)
+                    continue;
+
+                ServiceArea& area = areas[areaShare.index];
+                pPlant->reduceCapacity(piece);
+                line.reduceCapacity(delivered);
+                area.addCapacity(delivered);
+                recordAllocation(area, pPlant, &line, piece, plantAvailable - pPlant->getAvailableCapacity(), delivered);
+                totalDelivered += delivered;
+            }
+        }
+    }
+
+    if (verbose) {
+        cout << endl << "Minimum cost flow dispatch ("
+            << (objective == FLOW_MAX_PROFIT ? "most profit" : "most power delivered") << "): "
+            << fixed << setprecision(2) << totalDelivered << " MW delivered ("
+            << pivots << " pivots)." << endl;
+    }
+    return totalDelivered;
+}
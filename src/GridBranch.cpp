@@ -0,0 +1,86 @@
+// File: GridBranch.cpp
+//
+// Contains the functions of the PowerGrid class for copy-on-write branches,
+// used to run what-if scenarios (a plant offline, a throttle change, ...)
+// from one loaded grid.
+//
+// A branch starts with the plant pointers of the grid it was made from, so
+// no plant is copied when the branch is made.  The first time the branch
+// changes a plant, the plant is copied into the branch's own arena and the
+// branch's pointer is moved to the copy (see writablePlant).  A shared plant
+// is never changed, so any number of branches (on any number of threads) can
+// share the plants of one grid.  The grid they share must not change while
+// they exist.
+//
+// The areas and lines are small flat objects, and a distribution changes
+// almost all of them, so a branch gets its own copy of their vectors.  The
+// copies start out unconnected from the other grid's indexes and queue.
+//
+#include "../header/PowerGrid.h"
+
+using namespace std;
+
+
+//
+// branch():  Returns a new grid that shares this grid's plants until it
+//            changes them, with its own copy of the areas, lines, and
+//            allocation ledger.  A branch does not use the plant store.
+//
+unique_ptr<PowerGrid> PowerGrid::branch() const {
+    unique_ptr<PowerGrid> pBranch(new PowerGrid());
+    PowerGrid& grid = *pBranch;
+
+    grid.gridName = gridName;
+    grid.names = names;             // The shared plants keep their names in this table
+    grid.plants = plants;
+    grid.plantShared.assign(plants.size(), 1);
+    grid.inheritedPlantCount = plants.size();
+    grid.areas = areas;
+    grid.transmissionLines = transmissionLines;
+
+    grid.allocations = allocations;
+    grid.plantAllocations = plantAllocations;
+    grid.lineAllocations = lineAllocations;
+    grid.areaAllocations = areaAllocations;
+    grid.deadAllocations = deadAllocations;
+    grid.dirtyPlants = dirtyPlants;
+    grid.unratedPlants = unratedPlants;
+    grid.ratedOutputTotal = ratedOutputTotal;
+
+    grid.lineSelection = lineSelection;
+    grid.plantSelection = plantSelection;
+    grid.areaSchedule = areaSchedule;
+    grid.splitAllocations = splitAllocations;
+    grid.verbose = verbose;
+
+    // The indexes, the area queue, and the dispatch LP are built when first used
+    return pBranch;
+}
+
+
+//
+// writablePlant():  Returns plant i so it can be changed.  A plant still
+//            shared with the other grid is copied into this grid first, and
+//            the copy takes the plant's place in the lists and the index.
+//
+PowerPlant* PowerGrid::writablePlant(size_t i) {
+    if (!isPlantShared(i))
+        return plants[i];
+
+    PlantState state;
+    plants[i]->saveState(state);
+
+    PowerPlant* pCopy = plantArena.clone(*plants[i]);
+    pCopy->attachGridLists(&dirtyPlants, &unratedPlants, i);
+    pCopy->restoreState(state);         // Also copies whether the plant is dirty
+
+    if (!plantIndexStale) {
+        size_t slot = plantIndexSlot[i];
+        plantIndexOrder[slot] = pCopy;
+        pCopy->attachIndex(&plantIndex, slot);
+    }
+
+    plants[i] = pCopy;
+    plantShared[i] = 0;
+    return pCopy;
+}
@@ -0,0 +1,263 @@
+// File: GridFile.cpp
+//
+// Contains the function definitions for the MappedFile and TextScanner classes
+// used to read the grid data files.
+//
+#include <charconv>
+#include "../header/GridFile.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//********************************************************
+//*****               Mapped File                    *****
+//********************************************************
+
+//
+// open() - Maps the whole file read only.  Returns false if the file
+//          could not be opened or mapped.
+//
+bool MappedFile::open(const string& filename) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    hFile = file;
+    size = (size_t)fileSize.QuadPart;
+    opened = true;
+
+    // An empty file can not be mapped, but it is still a valid (empty) file
+    if (size == 0)
+        return true;
+
+    hMapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (hMapping != NULL)
+        pData = (const char*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (pData == nullptr) {
+        close();
+        return false;
+    }
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    size = (size_t)info.st_size;
+    opened = true;
+
+    // An empty file can not be mapped, but it is still a valid (empty) file
+    if (size > 0) {
+        void* pMap = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pMap == MAP_FAILED) {
+            ::close(fd);
+            size = 0;
+            opened = false;
+            return false;
+        }
+        pData = (const char*)pMap;
+        madvise(pMap, size, MADV_SEQUENTIAL);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+#endif
+
+    return true;
+}
+
+
+//
+// close() - Releases the mapping (if any)
+//
+void MappedFile::close() {
+#ifdef _WIN32
+    if (pData != nullptr)   UnmapViewOfFile(pData);
+    if (hMapping != nullptr) CloseHandle((HANDLE)hMapping);
+    if (hFile != nullptr)    CloseHandle((HANDLE)hFile);
+    hMapping = nullptr;
+    hFile = nullptr;
+#else
+    if (pData != nullptr)
+        munmap((void*)pData, size);
+#endif
+
+    pData = nullptr;
+    size = 0;
+    opened = false;
+}
+
+
+
+//********************************************************
+//*****               Text Scanner                   *****
+//********************************************************
+
+// Whitespace test that does not depend on the current locale
+static inline bool isSpaceChar(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\v' || ch == '\f';
+}
+
+//
+// skipWhitespace() - Moves the position past spaces, tabs, and line breaks
+//
+void TextScanner::skipWhitespace() {
+    while (pos < text.size() && isSpaceChar(text[pos]))
+        pos++;
+}
+
+
+//
+// nextLine() - Returns the rest of the current line.  A trailing carriage
+//              return (Windows line ending) is not part of the line.
+//
+string_view TextScanner::nextLine() {
+    size_t start = pos;
+    size_t end = text.find('\n', pos);
+
+    if (end == string_view::npos) {
+        end = text.size();
+        pos = end;
+    }
+    else {
+        pos = end + 1;
+    }
+
+    if (end > start && text[end - 1] == '\r')
+        end--;
+
+    return text.substr(start, end - start);
+}
+
+
+//
+// skipPastLine() - Skips the informational header lines at the start of a
+//                  data file.  Returns false if the delimiter was not found.
+//
+bool TextScanner::skipPastLine(string_view delimiter) {
+    while (!atEnd()) {
+        string_view line = nextLine();
+
+        // Ignore any trailing blanks after the delimiter
+        while (!line.empty() && isSpaceChar(line.back()))
+            line.remove_suffix(1);
+
+        if (line == delimiter)
+            return true;
+    }
+    return false;
+}
+
+
+//
+// nextToken() - Returns the next whitespace separated token
+//
+string_view TextScanner::nextToken() {
+    skipWhitespace();
+
+    size_t start = pos;
+    while (pos < text.size() && !isSpaceChar(text[pos]))
+        pos++;
+
+    return text.substr(start, pos - start);
+}
+
+
+//
+// readUntil() - Skips leading whitespace and returns the text up to the
+//               delimiter.  The delimiter itself is consumed.
+//
+bool TextScanner::readUntil(char delimiter, string_view& field) {
+    skipWhitespace();
+
+    size_t end = text.find(delimiter, pos);
+    if (end == string_view::npos) {
+        pos = text.size();
+        return false;
+    }
+
+    field = text.substr(pos, end - pos);
+    pos = end + 1;
+    return true;
+}
+
+
+
+//
+// splitField() - Returns the text of the line up to the delimiter without
+//                the blanks around it, and removes it and the delimiter
+//                from the line
+//
+string_view TextScanner::splitField(string_view& line, char delimiter) {
+    size_t end = line.find(delimiter);
+    string_view field = line.substr(0, end);
+    line = end == string_view::npos ? string_view() : line.substr(end + 1);
+
+    while (!field.empty() && isSpaceChar(field.front()))
+        field.remove_prefix(1);
+    while (!field.empty() && isSpaceChar(field.back()))
+        field.remove_suffix(1);
+    return field;
+}
+
+//
+// nextDouble(), nextInt() - Read the next token as a number
+//
+bool TextScanner::nextDouble(double& value) {
+    return parseDouble(nextToken(), value);
+}
+
+bool TextScanner::nextInt(int& value) {
+    return parseInt(nextToken(), value);
+}
+
+
+//
+// parseDouble(), parseInt() - Convert a complete token to a number.  The
+//              conversion does not use the locale so it is safe to call
+//              from any thread.
+//
+bool TextScanner::parseDouble(string_view token, double& value) {
+    if (token.empty())
+        return false;
+
+    const char* first = token.data();
+    const char* last = token.data() + token.size();
+    auto result = from_chars(first, last, value);
+    return result.ec == errc() && result.ptr == last;
+}
+
+bool TextScanner::parseInt(string_view token, int& value) {
+    if (token.empty())
+        return false;
+
+    const char* first = token.data();
+    const char* last = token.data() + token.size();
+    auto result = from_chars(first, last, value);
+    return result.ec == errc() && result.ptr == last;
+}
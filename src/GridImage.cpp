@@ -0,0 +1,343 @@
+// File: GridImage.cpp
+//
+// Contains the functions of the PowerGrid class that save and load the
+// precompiled binary grid image.  The layout of the file is described in
+// GridImage.h.
+//
+// The image is built once from the text data files (see tools/MakeGridImage.cpp)
+// and is loaded by initializeGrid when it is newer than all of the text files.
+// Loading maps the whole file with one call and creates the objects directly
+// from the fixed width records, so no text parsing is done at startup.  The
+// names are read from the mapped image and are not copied.  Every area,
+// plant, and line is still created, so startup is fast but the load time
+// still grows with the size of the grid.
+//
+#include <cstring>
+#include <filesystem>
+#include "../header/PowerGrid.h"
+#include "../header/GridFile.h"
+#include "../header/GridImage.h"
+
+using namespace std;
+
+// Round a file offset up to the next 8 byte boundary
+static inline uint64_t alignOffset(uint64_t offset) {
+    return (offset + 7) & ~uint64_t(7);
+}
+
+
+//
+// isGridImageCurrent() - Returns true if the image file exists and was
+//              written after every one of the source data files.
+//
+bool PowerGrid::isGridImageCurrent(const string& imageFilename, const vector<string>& sourceFilenames) {
+    error_code ec;
+
+    auto imageTime = filesystem::last_write_time(imageFilename, ec);
+    if (ec)
+        return false;       // No image file
+
+    for (const auto& source : sourceFilenames) {
+        auto sourceTime = filesystem::last_write_time(source, ec);
+        if (!ec && sourceTime > imageTime)
+            return false;   // A data file changed after the image was built
+    }
+    return true;
+}
+
+
+//
+// writeGridImage() - Saves the areas, plants, and lines of the grid to a
+//              binary image file.  Returns 0 if the file was written.
+//
+int PowerGrid::writeGridImage(const string& filename) const {
+
+    // The names section is the grid's name table in NameID order, so the
+    // records keep the NameIDs of the objects
+    string stringTable;
+    vector<ImageString> nameRecords(names->size());
+    for (size_t i = 0; i < nameRecords.size(); i++) {
+        string_view text = names->view((NameID)i);
+        nameRecords[i].offset = (uint32_t)stringTable.size();
+        nameRecords[i].length = (uint32_t)text.size();
+        stringTable += text;
+    }
+
+    // Build the fixed width records for each section
+    vector<AreaRecord> areaRecords;
+    areaRecords.reserve(areas.size());
+    for (const auto& area : areas) {
+        AreaRecord rec = {};
+        rec.name = area.getAreaNameID();
+        rec.powerRequired = area.getPowerRequired();
+        rec.mwPrice = area.getMWPrice();
+        areaRecords.push_back(rec);
+    }
+
+    vector<PlantRecord> plantRecords;
+    plantRecords.reserve(plants.size());
+    for (const auto& plant : plants) {
+        PlantRecord rec = {};
+        rec.name = plant->getNameID();
+        rec.maxOutput = plant->getMaxPowerOutput();
+        rec.operatingCost = plant->getOperatingCost();
+
+        switch (plant->getPlantType()) {
+        case PlantType::Solar: {
+            const SolarFarm* pSolar = static_cast<const SolarFarm*>(plant);
+            rec.type = IMG_SOLAR;
+            rec.param1 = pSolar->getNumAcres();
+            rec.param2 = pSolar->getSunlightHours();
+            break;
+        }
+        case PlantType::Wind: {
+            const WindFarm* pWind = static_cast<const WindFarm*>(plant);
+            rec.type = IMG_WIND;
+            rec.intParam = pWind->getTurbineCount();
+            rec.param1 = pWind->getBladeLength();
+            rec.param2 = pWind->getAvgWindSpeed();
+            break;
+        }
+        case PlantType::Hydro: {
+            const HydroPlant* pHydro = static_cast<const HydroPlant*>(plant);
+            rec.type = IMG_HYDRO;
+            rec.param1 = pHydro->getFlowRate();
+            rec.param2 = pHydro->getVerticalDrop();
+            break;
+        }
+        case PlantType::Nuclear: {
+            const NuclearPlant* pNuclear = static_cast<const NuclearPlant*>(plant);
+            rec.type = IMG_NUCLEAR;
+            rec.intParam = pNuclear->getFuelRods();
+            break;
+        }
+        case PlantType::Geothermal:
+            rec.type = IMG_GEOTHERMAL;
+            break;
+        case PlantType::Gas: {
+            const GasPlant* pGas = static_cast<const GasPlant*>(plant);
+            rec.type = IMG_GAS;
+            rec.fuelType = pGas->getFuelTypeID();
+            rec.param1 = pGas->getThrottle();
+            break;
+        }
+        default:
+            cerr << "Error: Plant type " << plant->getType() << " can not be saved in a grid image" << endl;
+            return -1;
+        }
+        plantRecords.push_back(rec);
+    }
+
+    vector<LineRecord> lineRecords;
+    lineRecords.reserve(transmissionLines.size());
+    for (const auto& line : transmissionLines) {
+        LineRecord rec = {};
+        rec.name = line.getLineNameID();
+        rec.lineID = line.getLineID();
+        rec.capacity = line.getMaxCapacity();
+        rec.efficiency = line.getEfficiency();
+        lineRecords.push_back(rec);
+    }
+
+    // Fill in the header with the location of each section
+    GridImageHeader header = {};
+    memcpy(header.magic, GRID_IMAGE_MAGIC, sizeof(header.magic));
+    header.version = GRID_IMAGE_VERSION;
+    header.byteOrder = GRID_IMAGE_BYTEORDER;
+    header.areaCount = (uint32_t)areaRecords.size();
+    header.plantCount = (uint32_t)plantRecords.size();
+    header.lineCount = (uint32_t)lineRecords.size();
+    header.nameCount = (uint32_t)nameRecords.size();
+    header.stringTableSize = (uint32_t)stringTable.size();
+    header.areaOffset = alignOffset(sizeof(GridImageHeader));
+    header.plantOffset = alignOffset(header.areaOffset + areaRecords.size() * sizeof(AreaRecord));
+    header.lineOffset = alignOffset(header.plantOffset + plantRecords.size() * sizeof(PlantRecord));
+    header.nameOffset = alignOffset(header.lineOffset + lineRecords.size() * sizeof(LineRecord));
+    header.stringOffset = alignOffset(header.nameOffset + nameRecords.size() * sizeof(ImageString));
+
+    // Assemble the whole image in memory and write it with one call
+    vector<char> image(header.stringOffset + stringTable.size(), 0);
+    memcpy(image.data(), &header, sizeof(header));
+    if (!areaRecords.empty())
+        memcpy(image.data() + header.areaOffset, areaRecords.data(), areaRecords.size() * sizeof(AreaRecord));
+    if (!plantRecords.empty())
+        memcpy(image.data() + header.plantOffset, plantRecords.data(), plantRecords.size() * sizeof(PlantRecord));
+    if (!lineRecords.empty())
+        memcpy(image.data() + header.lineOffset, lineRecords.data(), lineRecords.size() * sizeof(LineRecord));
+    if (!nameRecords.empty())
+        memcpy(image.data() + header.nameOffset, nameRecords.data(), nameRecords.size() * sizeof(ImageString));
+    if (!stringTable.empty())
+        memcpy(image.data() + header.stringOffset, stringTable.data(), stringTable.size());
+
+    ofstream osImage(filename, ios::binary | ios::trunc);
+    if (!osImage) {
+        cerr << "Error: Unable to create grid image " << filename << endl;
+        return -1;
+    }
+    osImage.write(image.data(), (streamsize)image.size());
+    if (!osImage) {
+        cerr << "Error: Unable to write grid image " << filename << endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+//
+// readGridImage() - Loads the areas, plants, and lines from a binary image
+//              file.  The whole image is checked before anything is added to
+//              the grid.  If the grid has no names yet the grid's name table
+//              takes over the mapped image and reads the names from it.
+//              Returns 0 if the image was loaded.
+//
+int PowerGrid::readGridImage(const string& filename) {
+
+    unique_ptr<MappedFile> pImageFile(new MappedFile());
+    if (!pImageFile->open(filename)) {
+        cerr << "Error: Unable to open grid image " << filename << endl;
+        return -1;
+    }
+    string_view image = pImageFile->view();
+
+    // Check the header
+    GridImageHeader header;
+    if (image.size() < sizeof(header)) {
+        cerr << "Error: Grid image " << filename << " is too small" << endl;
+        return -2;
+    }
+    memcpy(&header, image.data(), sizeof(header));
+
+    if (memcmp(header.magic, GRID_IMAGE_MAGIC, sizeof(header.magic)) != 0
+        || header.byteOrder != GRID_IMAGE_BYTEORDER
+        || header.version != GRID_IMAGE_VERSION) {
+        cerr << "Error: " << filename << " is not a grid image of version " << GRID_IMAGE_VERSION << endl;
+        return -2;
+    }
+
+    // Lambda function to check that a section lies inside the file
+    auto sectionFits = [&](uint64_t offset, uint64_t count, uint64_t recordSize) {
+        return offset <= image.size() && count <= (image.size() - offset) / recordSize;
+    };
+
+    // The names section is used in place, so it must be aligned for ImageString
+    if (!sectionFits(header.areaOffset, header.areaCount, sizeof(AreaRecord))
+        || !sectionFits(header.plantOffset, header.plantCount, sizeof(PlantRecord))
+        || !sectionFits(header.lineOffset, header.lineCount, sizeof(LineRecord))
+        || !sectionFits(header.nameOffset, header.nameCount, sizeof(ImageString))
+        || !sectionFits(header.stringOffset, header.stringTableSize, 1)
+        || (uintptr_t)(image.data() + header.nameOffset) % alignof(ImageString) != 0) {
+        cerr << "Error: Grid image " << filename << " is truncated" << endl;
+        return -2;
+    }
+
+    const char* pStrings = image.data() + header.stringOffset;
+    const ImageString* pNames = reinterpret_cast<const ImageString*>(image.data() + header.nameOffset);
+
+    // Lambda functions to copy a record out of the image (the records are
+    // copied so the mapping does not need to be aligned for them)
+    auto getArea = [&](uint32_t i) {
+        AreaRecord rec;
+        memcpy(&rec, image.data() + header.areaOffset + i * sizeof(AreaRecord), sizeof(rec));
+        return rec;
+    };
+    auto getPlant = [&](uint32_t i) {
+        PlantRecord rec;
+        memcpy(&rec, image.data() + header.plantOffset + i * sizeof(PlantRecord), sizeof(rec));
+        return rec;
+    };
+    auto getLine = [&](uint32_t i) {
+        LineRecord rec;
+        memcpy(&rec, image.data() + header.lineOffset + i * sizeof(LineRecord), sizeof(rec));
+        return rec;
+    };
+
+    // Check every name, name reference, and plant type before changing the grid
+    for (uint32_t i = 0; i < header.nameCount; i++) {
+        if (pNames[i].offset > header.stringTableSize || pNames[i].length > header.stringTableSize - pNames[i].offset) {
+            cerr << "Error: Grid image " << filename << " has a bad name" << endl;
+            return -2;
+        }
+    }
+    for (uint32_t i = 0; i < header.areaCount; i++) {
+        if (getArea(i).name >= header.nameCount) {
+            cerr << "Error: Grid image " << filename << " has a bad area record" << endl;
+            return -2;
+        }
+    }
+    for (uint32_t i = 0; i < header.plantCount; i++) {
+        PlantRecord rec = getPlant(i);
+        if (rec.name >= header.nameCount || (rec.type == IMG_GAS && rec.fuelType >= header.nameCount)
+            || rec.type < IMG_SOLAR || rec.type > IMG_GAS) {
+            cerr << "Error: Grid image " << filename << " has a bad plant record" << endl;
+            return -2;
+        }
+    }
+    for (uint32_t i = 0; i < header.lineCount; i++) {
+        if (getLine(i).name >= header.nameCount) {
+            cerr << "Error: Grid image " << filename << " has a bad line record" << endl;
+            return -2;
+        }
+    }
+
+    // The image names keep their NameIDs in an empty name table.  Otherwise
+    // each name of the image is added to the grid's table.
+    vector<NameID> nameIDs;
+    if (names->size() == 0) {
+        names->adoptImageNames(move(pImageFile), pStrings, pNames, header.nameCount);
+    }
+    else {
+        nameIDs.resize(header.nameCount);
+        for (uint32_t i = 0; i < header.nameCount; i++)
+            nameIDs[i] = names->intern(string_view(pStrings + pNames[i].offset, pNames[i].length));
+    }
+    auto gridName = [&](uint32_t imageID) {
+        return nameIDs.empty() ? (NameID)imageID : nameIDs[imageID];
+    };
+
+    // Create the objects from the records
+    areas.reserve(areas.size() + header.areaCount);
+    for (uint32_t i = 0; i < header.areaCount; i++) {
+        AreaRecord rec = getArea(i);
+        areas.emplace_back(gridName(rec.name), rec.powerRequired, rec.mwPrice);
+    }
+    areaQueueStale = true;
+    dispatchLPStale = true;
+
+    plants.reserve(plants.size() + header.plantCount);
+    for (uint32_t i = 0; i < header.plantCount; i++) {
+        PlantRecord rec = getPlant(i);
+        NameID name = gridName(rec.name);
+
+        switch (rec.type) {
+        case IMG_SOLAR:
+            addPlantToGrid(plantArena.create<SolarFarm>(name, rec.maxOutput, rec.operatingCost, rec.param1, rec.param2));
+            break;
+        case IMG_WIND:
+            addPlantToGrid(plantArena.create<WindFarm>(name, rec.maxOutput, rec.operatingCost, rec.intParam, rec.param1, rec.param2));
+            break;
+        case IMG_HYDRO:
+            addPlantToGrid(plantArena.create<HydroPlant>(name, rec.maxOutput, rec.operatingCost, rec.param1, rec.param2));
+            break;
+        case IMG_NUCLEAR:
+            addPlantToGrid(plantArena.create<NuclearPlant>(name, rec.maxOutput, rec.operatingCost, rec.intParam));
+            break;
+        case IMG_GEOTHERMAL:
+            addPlantToGrid(plantArena.create<GeothermalPlant>(name, rec.maxOutput, rec.operatingCost));
+            break;
+        case IMG_GAS:
+            addPlantToGrid(plantArena.create<GasPlant>(name, rec.maxOutput, rec.operatingCost, gridName(rec.fuelType), rec.param1));
+            break;
+        }
+    }
+
+    transmissionLines.reserve(transmissionLines.size() + header.lineCount);
+    for (uint32_t i = 0; i < header.lineCount; i++) {
+        LineRecord rec = getLine(i);
+        transmissionLines.emplace_back(rec.lineID, gridName(rec.name), rec.capacity, rec.efficiency);
+    }
+    lineIndexStale = true;
+    dispatchLPStale = true;
+
+    return 0;
+}
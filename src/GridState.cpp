@@ -0,0 +1,108 @@
+// File: GridState.cpp
+//
+// Contains the functions of the PowerGrid class for running many scenarios
+// on one loaded grid.
+//
+// saveBaseline copies the state that changes while the grid is modeled (the
+// conditions and output of each plant, the power required by and provided
+// to each area, the power in use on each line, and the allocation ledger)
+// into arrays kept by the grid.  restoreBaseline copies it back in one pass
+// over each array.  Nothing is read from the data files, and after the first
+// save the arrays are reused, so a restore does not allocate memory.
+//
+// The capacity indexes and the area queue are rebuilt before the next
+// distribution rather than updated for every plant, line, and area.
+//
+#include "../header/PowerGrid.h"
+
+using namespace std;
+
+
+//
+// saveBaseline():  Saves the current state of every plant, area, and line
+//
+void PowerGrid::saveBaseline() {
+    baseline.plants.resize(plants.size());
+    for (size_t i = 0; i < plants.size(); i++)
+        plants[i]->saveState(baseline.plants[i]);
+
+    baseline.areas.resize(areas.size());
+    for (size_t i = 0; i < areas.size(); i++)
+        baseline.areas[i] = { areas[i].getPowerRequired(), areas[i].getPowerProvided() };
+
+    baseline.lines.resize(transmissionLines.size());
+    for (size_t i = 0; i < transmissionLines.size(); i++)
+        baseline.lines[i] = { transmissionLines[i].getCapacityInUse(), transmissionLines[i].getRemainingCapacity(),
+                              transmissionLines[i].getUsableFraction() };
+
+    baseline.allocations = allocations;
+    baseline.plantAllocations = plantAllocations;
+    baseline.lineAllocations = lineAllocations;
+    baseline.areaAllocations = areaAllocations;
+    baseline.deadAllocations = deadAllocations;
+    baseline.dirtyPlants = dirtyPlants;
+    baseline.ratedOutputTotal = ratedOutputTotal;
+    baseline.saved = true;
+}
+
+
+//
+// restoreBaseline():  Puts back the state saved by saveBaseline.  Returns
+//                  false if nothing was saved or plants, areas, or lines
+//                  were added since.
+//
+bool PowerGrid::restoreBaseline() {
+    if (!baseline.saved || baseline.plants.size() != plants.size()
+        || baseline.areas.size() != areas.size() || baseline.lines.size() != transmissionLines.size()) {
+        cerr << "Error: No saved baseline matches the grid" << endl;
+        return false;
+    }
+
+    // A plant a branch still shares has not changed since it was saved
+    unratedPlants.clear();
+    for (size_t i = 0; i < plants.size(); i++) {
+        if (!isPlantShared(i))
+            plants[i]->restoreState(baseline.plants[i]);
+        if (baseline.plants[i].ratingStale)
+            unratedPlants.push_back(i);
+    }
+
+    for (size_t i = 0; i < areas.size(); i++)
+        areas[i].restorePower(baseline.areas[i].required, baseline.areas[i].provided);
+
+    for (size_t i = 0; i < transmissionLines.size(); i++)
+        transmissionLines[i].restoreUsage(baseline.lines[i].inUse, baseline.lines[i].available, baseline.lines[i].usableFraction);
+
+    // Vector assignment reuses the memory the vectors already have
+    allocations = baseline.allocations;
+    plantAllocations = baseline.plantAllocations;
+    lineAllocations = baseline.lineAllocations;
+    areaAllocations = baseline.areaAllocations;
+    deadAllocations = baseline.deadAllocations;
+    dirtyPlants = baseline.dirtyPlants;
+    ratedOutputTotal = baseline.ratedOutputTotal;
+
+    plantIndexStale = true;
+    lineIndexStale = true;
+    areaQueueStale = true;
+    return true;
+}
+
+
+//
+// clearDispatch():  Releases all of the power allocated from the plants, to
+//                  the areas, and on the lines.  The plants keep their
+//                  conditions and output.
+//
+void PowerGrid::clearDispatch() {
+    for (size_t i = 0; i < plants.size(); i++) {
+        if (plants[i]->getCapacityAllocated() != 0.0)
+            writablePlant(i)->resetCapacity();
+    }
+    for (auto& area : areas)
+        area.resetPower();
+    for (auto& line : transmissionLines)
+        line.resetCapacity();
+
+    clearAllocationLedger();
+}
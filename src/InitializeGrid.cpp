@@ -4,9 +4,20 @@
 // This is currently a public member function of the PowerGrid class and 
 // it primarily uses private member functions of the Grid class.
 // 
+// The data files are mapped into memory (see GridFile.h) and parsed in place.
+// initializeGrid reads the three files on separate threads.
+// Names are string_views into the mapped file until the object is created.
+// Each reader adds the names to the name table of its own buffer, and the
+// names are moved into the grid's table when the buffers are merged.
+// The messages of each reader are held until its buffer is merged, so they
+// are printed in file order and nothing is printed after the first failure.
+//
 #include "../header/GridDef.h"
 #include "../header/PowerGrid.h"
-#include <cassert>
+#include "../header/GridFile.h"
+#include "../header/PlantStream.h"
+#include <future>
+#include <sstream>
 
 using namespace std;
 
@@ -14,25 +25,77 @@ using namespace std;
 //*****       Grid Initilization Function           *****
 //*******************************************************
 int PowerGrid::initializeGrid(const string name, 
-    const string demandFilename, const string plantFilename, const string transLineFilename) {
+    const string demandFilename, const string plantFilename, const string transLineFilename,
+    const string imageFilename) {
     
     int rc;     // muilt-use return Code
 
     cout << "Grid initialization beginning for " << name << endl;
     gridName = name;
+
+    // Start from an empty grid so initializing again does not keep old objects
+    clearGrid();
+
+    // Use the precompiled grid image if it is up to date with the data files
+    if (isGridImageCurrent(imageFilename, { demandFilename, plantFilename, transLineFilename })) {
+        rc = readGridImage(imageFilename);
+        if (rc == 0) {
+            cout << "Grid image " << imageFilename << " successfully loaded." << endl;
+            cout << endl;
+            return 0;
+        }
+        cout << "Grid image could not be used, reading data files." << endl;
+    }
         
-    // Read the data files and populate the vector for each major object 
-    rc = readServceAreaData(demandFilename);
-    if (rc != 0)  return rc;
-    cout << "Demand data successfully completed." << endl;
-     
-    rc = readPlantData(plantFilename);
-    if (rc != 0)  return rc;
-    cout << "Plant data successfully completed." << endl;
-
-    rc = readTransmissionLineData(transLineFilename);
-    if (rc != 0)  return rc;
-    cout << "Transmission Line data successfully completed." << endl;
+    // Read the three data files at the same time.  Each reader fills its own
+    // buffer and message stream, so the readers do not share any state while they run.
+    // The plants are created in an arena of their own and the grid's arena
+    // takes it over when the plants are merged.
+    vector<ServiceArea>       areaBuffer;
+    NameTable                 areaNames;
+    vector<PowerPlant*>       plantBuffer;
+    PlantArena                plantBufferArena;
+    NameTable                 plantNames;
+    vector<TransmissionLine>  lineBuffer;
+    NameTable                 lineNames;
+    ostringstream             areaErrors, plantErrors, lineErrors;
+
+    auto areaTask  = async(launch::async, parseServiceAreaFile, cref(demandFilename), ref(areaBuffer), ref(areaNames), ref(areaErrors));
+    auto plantTask = async(launch::async, parsePlantFile, cref(plantFilename), ref(plantBuffer), ref(plantBufferArena), ref(plantNames), ref(plantErrors));
+    auto lineTask  = async(launch::async, parseTransmissionLineFile, cref(transLineFilename), ref(lineBuffer), ref(lineNames), ref(lineErrors));
+
+    int areaRC  = areaTask.get();
+    int plantRC = plantTask.get();
+    int lineRC  = lineTask.get();
+
+    // Merge the buffers into the grid in the original order, stopping at the
+    // first file that failed so the same return code and messages are
+    // reported (the messages of the files after it are dropped)
+    rc = areaRC;
+    cerr << areaErrors.str();
+    if (rc == 0) {
+        mergeServiceAreas(areaBuffer, areaNames);
+        cout << "Demand data successfully completed." << endl;
+
+        rc = plantRC;
+        cerr << plantErrors.str();
+    }
+
+    if (rc == 0) {
+        mergePlants(plantBuffer, plantBufferArena, plantNames);
+        cout << "Plant data successfully completed." << endl;
+
+        rc = lineRC;
+        cerr << lineErrors.str();
+    }
+
+    if (rc == 0) {
+        mergeTransmissionLines(lineBuffer, lineNames);
+        cout << "Transmission Line data successfully completed." << endl;
+    }
+    else {
+        return rc;
+    }
 
     cout << endl;
     return 0;
@@ -49,38 +112,56 @@ int PowerGrid::initializeGrid(const string name,
 //             from the data file and adds them to the grid
 //
 int PowerGrid::readServceAreaData(const string& filename) {
+    vector<ServiceArea> areaBuffer;
+    NameTable           areaNames;
+
+    int rc = parseServiceAreaFile(filename, areaBuffer, areaNames, cerr);
+    if (rc == 0)
+        mergeServiceAreas(areaBuffer, areaNames);
+    return rc;
+}
+
+
+//
+//  parseServiceAreaFile():   Reads the service areas from the data file into
+//             a buffer, with their names in the buffer's name table.
+//             Messages are written to errors.
+//             Does not use the grid so it may run on any thread.
+//
+int PowerGrid::parseServiceAreaFile(const string& filename, vector<ServiceArea>& areaBuffer, NameTable& bufferNames, ostream& errors) {
 
     // Variables used to read demand info from file
-    string  location;
+    string_view location;
     double  requestedPower;
     double  mwPricePaid;
 
-    // Declare input stream and open data file for reading
-    ifstream isDemand(filename);
-    if (!isDemand) {
-        cerr << "Error: Unable to open file " << filename << endl;
+    // Map the data file into memory for reading
+    MappedFile demandFile;
+    if (!demandFile.open(filename)) {
+        errors << "Error: Unable to open file " << filename << endl;
         return -1;
     }
+    TextScanner scanDemand(demandFile.view());
 
-    // Read and skip the two header lines
-    string  headerLine;
-    getline(isDemand, headerLine);
-    getline(isDemand, headerLine);
+    // Lambda function to read one record into local variables
+    auto readLineFromFile = [&]() {
+        location = scanDemand.nextToken();
+        return !location.empty()
+            && scanDemand.nextDouble(requestedPower)
+            && scanDemand.nextDouble(mwPricePaid);
+    };
 
-    // Read the first demand record
-    isDemand >> location >> requestedPower >> mwPricePaid;
+    // Skip the two header lines
+    scanDemand.nextLine();
+    scanDemand.nextLine();
 
     // Process all records in the file 
-    while (!isDemand.eof() && !isDemand.fail()) {
+    while (readLineFromFile()) {
 
-        // Add the demand location and required capacity to the grid
-        addServiceArea(location, requestedPower, mwPricePaid);
-
-        // Read next record
-        isDemand >> location >> requestedPower >> mwPricePaid;
+        // Add the demand location and required capacity to the buffer
+        areaBuffer.emplace_back(bufferNames.intern(location), requestedPower, mwPricePaid);
     }
 
-    isDemand.close();
     return 0;
 }
 
@@ -94,118 +175,89 @@ int PowerGrid::readServceAreaData(const string& filename) {
 //                  file and adds them to the grid
 //
 int PowerGrid::readPlantData(const string& filename) {
- 
-    // Variables used to read demand info from file
-    string name, type;
-    double costPerMW = 0.0;
-    double maxOutput = 0.0;
-
-    // Declare input stream and open data file for reading
-    ifstream isPlant(filename);
-    if (!isPlant) {
-        cerr << "Error: Unable to open Plant file " << filename << endl;
-        return -1;
-    }
-
-    // Lambda function to read first 3 fields of a line into local variables
-    auto readLineFromFile = [&]() {
-        isPlant >> std::ws;     // Skip all leading whitespace
-        getline(isPlant, name, ',');
-
-        // Read the remainder of the values on the line
-        isPlant >> type >> maxOutput >> costPerMW;
-    };
- 
-    /// Skip the informational header linesat start of file
-    string headerLine;
-    do {
-        getline(isPlant, headerLine);
-    } while (headerLine != FILE_HEADER_DELIMITER);
-
-
-    // Read the first line of file into local variables using local lambda function
-    readLineFromFile();       
+    vector<PowerPlant*> plantBuffer;
+    PlantArena          plantBufferArena;
+    NameTable           plantNames;
+
+    int rc = parsePlantFile(filename, plantBuffer, plantBufferArena, plantNames, cerr);
+    if (rc == 0)
+        mergePlants(plantBuffer, plantBufferArena, plantNames);
+    return rc;
+}
 
-    // Process all records in the file 
-    while (!isPlant.eof() && !isPlant.fail()) {
-
-        // Read the rest of the data depending on the type of the plant and add theplant to the grid
-        if (type == PT_SOLAR) {
-            double numAcres, sunlightHours;
-
-            // Read additional fields and declare solar farm
-            isPlant >> numAcres >> sunlightHours;
-            
-            // Allocate a solar farm object with information read
-            SolarFarm *pSolar = new SolarFarm(name, maxOutput, costPerMW, numAcres, sunlightHours);
-            addPlantToGrid(pSolar);
-        }
 
-        else if (type == PT_WIND) {
-            int turbineCnt;
-            double windSpeed;
-            double bladeLen;
+//
+//  parsePlantFile():   Reads the plants from the data file into a buffer.
+//                  The plants are created in the given arena, which owns them
+//                  until it is merged into the grid, with their names in the
+//                  buffer's name table.  Messages are written to errors.
+//                  Does not use the grid so it may run on any thread.
+//
+int PowerGrid::parsePlantFile(const string& filename, vector<PowerPlant*>& plantBuffer, PlantArena& plantArena, NameTable& bufferNames, ostream& errors) {
 
-            // Read additional fields and declare wind farm
-            isPlant >> turbineCnt >> bladeLen >> windSpeed;
+    // Fields of one plant record (see PlantStream.h)
+    PlantEntry entry;
 
-            // Allocate a wind farm object with information read
-            WindFarm *pWind = new WindFarm(name, maxOutput, costPerMW, turbineCnt, bladeLen, windSpeed);
-            addPlantToGrid(pWind);
-        }
+    // Map the data file into memory for reading
+    MappedFile plantFile;
+    if (!plantFile.open(filename)) {
+        errors << "Error: Unable to open Plant file " << filename << endl;
+        return -1;
+    }
+    TextScanner scanPlant(plantFile.view());
+ 
+    // Skip the informational header lines at start of file
+    if (!scanPlant.skipPastLine(FILE_HEADER_DELIMITER)) {
+        errors << "Error: No header delimiter found in Plant file " << filename << endl;
+        return -1;
+    }
 
-        else if (type == PT_HYDRO) {
-            double flowRate;
-            double drop;
 
-            // Read additional fields and declare hydro plant
-            isPlant >> flowRate >> drop;
+    // Process all records in the file 
+    PlantParseStatus status;
+    while ((status = parsePlantEntry(scanPlant, entry)) != PLANT_PARSE_END) {
 
-            // Allocate a hydro plant object with information read
-            HydroPlant *pHydro = new HydroPlant(name, maxOutput, costPerMW, flowRate, drop);
-            addPlantToGrid(pHydro);
+        if (status == PLANT_PARSE_BAD_TYPE) {
+            errors << "\nUnkown plant type found: " << entry.type << endl;
+            continue;       // The rest of its line was skipped
         }
 
-        else if (type == PT_NUCLEAR) {
-            int fuelRodsInUse;
-
-            // Read additional fields and declare nuclear plant
-            isPlant >> fuelRodsInUse;
+        // The name is copied into the buffer's name table
+        NameID name = bufferNames.intern(entry.name);
+        double maxOutput = entry.maxOutput;
+        double costPerMW = entry.operatingCost;
 
-            // Allocate a nuclear plant object with information read
-            NuclearPlant* pNuclear = new NuclearPlant(name, maxOutput, costPerMW, fuelRodsInUse);
-            addPlantToGrid(pNuclear);
-        }
+        PlantType type;
+        plantTypeFromName(entry.type, type);    // Known to be valid (not PLANT_PARSE_BAD_TYPE)
 
-        else if (type == PT_GEOTHERMAL) {
-            // Allocate a geothermal plant object with information read
-            GeothermalPlant* pGeothermal = new GeothermalPlant(name, maxOutput, costPerMW);
-            addPlantToGrid(pGeothermal);
-        }
+        // Allocate a plant object of the type read and add the plant to the buffer
+        switch (type) {
+        case PlantType::Solar:
+            plantBuffer.push_back(plantArena.create<SolarFarm>(name, maxOutput, costPerMW, entry.param1, entry.param2));
+            break;
 
-        else if (type == PT_GAS) {
+        case PlantType::Wind:
+            plantBuffer.push_back(plantArena.create<WindFarm>(name, maxOutput, costPerMW, entry.intParam, entry.param1, entry.param2));
+            break;
 
-            string fuelType;
-            double throttlePercent;
-            isPlant >> fuelType >> throttlePercent;
+        case PlantType::Hydro:
+            plantBuffer.push_back(plantArena.create<HydroPlant>(name, maxOutput, costPerMW, entry.param1, entry.param2));
+            break;
 
-            // Allocate a gas plant object with information read
-            GasPlant* pGas = new GasPlant(name, maxOutput, costPerMW, fuelType, throttlePercent);
-            addPlantToGrid(pGas);
-        }
+        case PlantType::Nuclear:
+            plantBuffer.push_back(plantArena.create<NuclearPlant>(name, maxOutput, costPerMW, entry.intParam));
+            break;
 
+        case PlantType::Geothermal:
+            plantBuffer.push_back(plantArena.create<GeothermalPlant>(name, maxOutput, costPerMW));
+            break;
 
-        else {
-            cerr << "\nUnkown plant type found: " << type << endl;
-            assert(false);
+        case PlantType::Gas:
+            plantBuffer.push_back(plantArena.create<GasPlant>(name, maxOutput, costPerMW, bufferNames.intern(entry.fuelType), entry.param1));
+            break;
         }
-        
-        // Read the next line of the file using local lambda function
-        readLineFromFile();        
     }
 
-    // Close the file and return
-    isPlant.close();
     return 0;
  }
 
@@ -221,66 +273,76 @@ int PowerGrid::readPlantData(const string& filename) {
 //              from the data file and adds them to the grid
 //
 int PowerGrid::readTransmissionLineData(const string& fileName) {
+    vector<TransmissionLine> lineBuffer;
+    NameTable                lineNames;
+
+    int rc = parseTransmissionLineFile(fileName, lineBuffer, lineNames, cerr);
+    if (rc == 0)
+        mergeTransmissionLines(lineBuffer, lineNames);
+    return rc;
+}
+
+
+//
+//  parseTransmissionLineFile():   Reads the transLines from the data file into
+//              a buffer, with their names in the buffer's name table.
+//              Messages are written to errors.
+//              Does not use the grid so it may run on any thread.
+//
+int PowerGrid::parseTransmissionLineFile(const string& fileName, vector<TransmissionLine>& lineBuffer, NameTable& bufferNames, ostream& errors) {
 
     // Variables used to read transmission line info from file
     int     lineID = 0;
     string  lineName;
     double  lineCapacity = 0.0;
     double  efficiency = 0.0;
-    string  temp;
+    string_view temp;
 
 
-    // Declare input stream and open data file for reading
-    ifstream isTransmissionLine(fileName);
-    if (!isTransmissionLine) {
-        cerr << "Error: Unable to open file " << fileName << endl;
+    // Map the data file into memory for reading
+    MappedFile transLineFile;
+    if (!transLineFile.open(fileName)) {
+        errors << "Error: Unable to open file " << fileName << endl;
         return -1;
     }
+    TextScanner scanLine(transLineFile.view());
 
 
     // Read and skip the header lines until the delimiter is econtered
-    string headerLine;
-    do {
-        getline(isTransmissionLine, headerLine);
-    } while (headerLine != FILE_HEADER_DELIMITER);
+    if (!scanLine.skipPastLine(FILE_HEADER_DELIMITER)) {
+        errors << "Error: No header delimiter found in file " << fileName << endl;
+        return -1;
+    }
  
 
 
     // Lambda function to read a line from file and parse into local varaibles
     auto readLineFromFile = [&]() {
 
-        isTransmissionLine >> lineID;    // first field is Line ID (an integer)
+        if (!scanLine.nextInt(lineID))     // first field is Line ID (an integer)
+            return false;
 
         // The name of line may be multiple words - read until we get a digit
-        isTransmissionLine >> lineName;        // Read first word
-        isTransmissionLine >> temp;            // Read next info in the file
-        while (!isdigit(temp[0])) {     // If it does not start with a digit it is part of the name
-            lineName = lineName + " " + temp;
-            isTransmissionLine >> temp;
-
-            if (isTransmissionLine.fail())     // Check if something went wrong in the stream
-                return;
+        temp = scanLine.nextToken();        // Read first word
+        if (temp.empty())
+            return false;
+        lineName.assign(temp.data(), temp.size());
+
+        temp = scanLine.nextToken();        // Read next info in the file
+        while (!temp.empty() && !isdigit((unsigned char)temp[0])) {   // If it does not start with a digit it is part of the name
+            lineName += ' ';
+            lineName.append(temp.data(), temp.size());
+            temp = scanLine.nextToken();
         }
 
-        // The value in temp is the value for capacity
-        lineCapacity = stod(temp);
-
-        // Last value on line is the efficiency
-        isTransmissionLine >> efficiency;
+        // The value in temp is the value for capacity and the last value on line is the efficiency
+        return TextScanner::parseDouble(temp, lineCapacity) && scanLine.nextDouble(efficiency);
      };
 
-    // Read the first transLine record from the file using lambda function
-    readLineFromFile();
-    
     // Process the records in the file 
-    while (!isTransmissionLine.eof() && !isTransmissionLine.fail()) {
-
-        addTransmissionLine(lineID, lineName, lineCapacity, efficiency);
-
-        // Read the next line of the file using local lambda function
-        readLineFromFile();
+    while (readLineFromFile()) {
+        lineBuffer.emplace_back(lineID, bufferNames.intern(lineName), lineCapacity, efficiency);
     }
 
-    isTransmissionLine.close();
     return 0;
 }
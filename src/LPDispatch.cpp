@@ -0,0 +1,126 @@
+// File: LPDispatch.cpp
+//
+// Contains the functions of the PowerGrid class for the profit maximizing
+// dispatch, solved as a linear program with the in-tree SparseLP solver.
+//
+// The LP maximizes the operating profit reported by generateUsageReport
+// (revenue of the areas minus the cost of the power drawn from the plants):
+//
+//      g_i  MW drawn from plant i      0 <= g_i <= available capacity
+//      u_l  MW sent into line l        0 <= u_l <= remaining capacity / efficiency
+//      v_j  MW delivered to area j     0 <= v_j <= unmet demand
+//
+//      row 0:  sum g_i                  - sum u_l = 0     (power drawn is sent on the lines)
+//      row 1:  sum efficiency_l * u_l   - sum v_j = 0     (power left after the line losses)
+//
+//      maximize  sum mwPrice_j * v_j  -  sum operatingCost_i * g_i
+//
+// Every line can reach every area, so the power leaving the lines can be
+// split among the areas in any way.  The line and area limits are then just
+// bounds on single variables, and the LP has only 2 rows no matter how large
+// the grid is.
+//
+// The LP is built once from the grid's vectors and kept.  Each solve only
+// updates the bounds from the current state of the plants, lines, and
+// areas, so the solver warm starts from the basis of the last solve.
+//
+#include "../header/PowerGrid.h"
+
+using namespace std;
+
+// Unmet demand of an area (0 if the area has all the power it needs)
+static double unmetDemand(const ServiceArea& area) {
+    return max(0.0, area.getPowerRequired() - area.getPowerProvided());
+}
+
+
+//
+// buildDispatchLP():  Builds the variables and rows of the dispatch LP.  The
+//                  bounds are set by optimizeProfit before each solve.
+//
+void PowerGrid::buildDispatchLP() {
+    dispatchLP.clear();
+
+    int drawnRow = dispatchLP.addRow(LP_EQUAL, 0.0);
+    int deliveredRow = dispatchLP.addRow(LP_EQUAL, 0.0);
+
+    for (auto pPlant : plants) {
+        int var = dispatchLP.addVariable(0.0, 0.0, pPlant->getOperatingCost());
+        dispatchLP.addCoefficient(drawnRow, var, 1.0);
+    }
+    for (auto& line : transmissionLines) {
+        int var = dispatchLP.addVariable(0.0, 0.0, 0.0);
+        dispatchLP.addCoefficient(drawnRow, var, -1.0);
+        dispatchLP.addCoefficient(deliveredRow, var, line.getEfficiency());
+    }
+    for (auto& area : areas) {
+        int var = dispatchLP.addVariable(0.0, 0.0, -area.getMWPrice());     // The LP minimizes
+        dispatchLP.addCoefficient(deliveredRow, var, -1.0);
+    }
+
+    dispatchLPStale = false;
+}
+
+
+//
+// optimizeProfit():  Dispatches the plants to the areas for the most profit.
+//                  The result is written into the plants, lines, and areas.
+//                  Returns the MW delivered to the areas.
+//
+double PowerGrid::optimizeProfit() {
+    if (dispatchLPStale)
+        buildDispatchLP();
+
+    // Variables are in the order: plants, lines, areas
+    int lineBase = (int)plants.size();
+    int areaBase = lineBase + (int)transmissionLines.size();
+
+    for (size_t i = 0; i < plants.size(); i++)
+        dispatchLP.setBounds((int)i, 0.0, max(0.0, plants[i]->getAvailableCapacity()));
+
+    for (size_t l = 0; l < transmissionLines.size(); l++) {
+        const TransmissionLine& line = transmissionLines[l];
+        double gross = line.getEfficiency() > 0.0 ? max(0.0, line.getRemainingCapacity()) / line.getEfficiency() : 0.0;
+        dispatchLP.setBounds(lineBase + (int)l, 0.0, gross);
+    }
+
+    for (size_t j = 0; j < areas.size(); j++)
+        dispatchLP.setBounds(areaBase + (int)j, 0.0, unmetDemand(areas[j]));
+
+    LPStatus status = dispatchLP.solve();
+    if (status != LP_OPTIMAL) {
+        cerr << "Error: The dispatch LP could not be solved (status " << status << ")" << endl;
+        return 0.0;
+    }
+
+    // Write the solution back (values below the tolerance are rounding)
+    for (size_t i = 0; i < plants.size(); i++) {
+        double drawn = min(dispatchLP.getValue((int)i), plants[i]->getAvailableCapacity());
+        if (drawn > SparseLP::TOLERANCE)
+            writablePlant(i)->reduceCapacity(drawn);
+    }
+
+    for (size_t l = 0; l < transmissionLines.size(); l++) {
+        TransmissionLine& line = transmissionLines[l];
+        double carried = min(dispatchLP.getValue(lineBase + (int)l) * line.getEfficiency(), line.getRemainingCapacity());
+        if (carried > SparseLP::TOLERANCE)
+            line.reduceCapacity(carried);
+    }
+
+    double totalDelivered = 0.0;
+    for (size_t j = 0; j < areas.size(); j++) {
+        double delivered = min(dispatchLP.getValue(areaBase + (int)j), unmetDemand(areas[j]));
+        if (delivered > SparseLP::TOLERANCE) {
+            areas[j].addCapacity(delivered);
+            totalDelivered += delivered;
+        }
+    }
+
+    if (verbose) {
+        cout << endl << "Profit maximizing dispatch: "
+            << fixed << setprecision(2) << totalDelivered << " MW delivered, profit $" << 0.0 - dispatchLP.getObjective()
+            << " (" << dispatchLP.getIterations() << " pivots, "
+            << (dispatchLP.wasWarmStart() ? "warm" : "cold") << " start)." << endl;
+    }
+    return totalDelivered;
+}
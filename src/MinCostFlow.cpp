@@ -0,0 +1,438 @@
+// File: MinCostFlow.cpp
+//
+// Contains the function definitions for the MinCostFlow class (see MinCostFlow.h)
+//
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cassert>
+#include "../header/MinCostFlow.h"
+
+using namespace std;
+
+static const double INFINITE_FLOW = numeric_limits<double>::infinity();
+const int DEGENERATE_PIVOTS = 50;   // Pivots in a row that move no flow before Bland's rule is used
+
+
+// A column of the simplex: an arc, or the artificial of a node.  A column has
+// an entry in the row of each end of the arc that is not the source or the
+// sink: +1 where the flow leaves and -gain where it arrives.  An artificial
+// has +1 in the row of its node and is fixed at 0; the artificials make up
+// the first basis and leave it as the arcs come in.
+struct FlowColumn {
+    int     row[2];         // -1 if there is no entry
+    double  coef[2];
+    double  upper;
+    double  cost;
+};
+
+enum ColumnState : uint8_t { AT_LOWER, AT_UPPER, BASIC };
+
+
+//
+// NetworkSimplex - The simplex on the columns of a network with gains.  The
+//          basis is kept as a list of basic columns, and its trees are
+//          found again from that list before each pivot.
+//
+class NetworkSimplex {
+private:
+    int             rows;
+    vector<FlowColumn>  cols;
+    vector<double>  x;              // Flow of each column
+    vector<ColumnState> state;
+    vector<int>     basicSlot;      // Position of each basic column in basic (-1 if not basic)
+    vector<int>     basic;
+
+    // Trees of the basis.  order lists the rows of each tree from its root,
+    // each row after its parent; tree t is order[treeFirst[t]] up to
+    // order[treeFirst[t + 1]].  parentCol joins a row to its parent.
+    vector<int>     incidentFirst, incident;
+    vector<int>     order, parentCol, treeOf, treeFirst, treeExtra;
+
+    // Work arrays of solveTrees: a value a + b * t of each row and column,
+    // t being the flow of the extra column of the tree
+    vector<double>  rowA, rowB, colA, colB;
+
+    int otherRow(int c, int r) const { return cols[c].row[0] == r ? cols[c].row[1] : cols[c].row[0]; }
+    double coefAt(int c, int r) const { return cols[c].row[0] == r ? cols[c].coef[0] : cols[c].coef[1]; }
+
+    void findTrees();
+    void findPotentials(vector<double>& potential);
+    void solveTrees(const vector<double>& rhs, const vector<int>& trees, vector<double>& y);
+
+public:
+    NetworkSimplex(int rowCount, vector<FlowColumn>& columns);
+
+    int run(int maxPivots);             // Returns the pivots taken
+    double getValue(int c) const { return x[c]; }
+};
+
+
+//
+// NetworkSimplex() - Starts with every column at 0 and the artificials
+//          (the last rowCount columns) basic
+//
+NetworkSimplex::NetworkSimplex(int rowCount, vector<FlowColumn>& columns)
+    : rows(rowCount), x(columns.size(), 0.0), state(columns.size(), AT_LOWER), basicSlot(columns.size(), -1) {
+    cols.swap(columns);
+    for (int r = 0; r < rows; r++) {
+        int c = (int)cols.size() - rows + r;
+        state[c] = BASIC;
+        basicSlot[c] = r;
+        basic.push_back(c);
+    }
+    colA.resize(cols.size());
+    colB.resize(cols.size());
+}
+
+
+//
+// findTrees() - Walks the basic columns from each row not yet in a tree.  A
+//          basic column that does not join a new row to the tree is the
+//          tree's extra column.
+//
+void NetworkSimplex::findTrees() {
+    incidentFirst.assign(rows + 1, 0);
+    for (int c : basic) {
+        for (int k = 0; k < 2; k++) {
+            if (cols[c].row[k] >= 0)
+                incidentFirst[cols[c].row[k] + 1]++;
+        }
+    }
+    for (int r = 0; r < rows; r++)
+        incidentFirst[r + 1] += incidentFirst[r];
+    incident.resize(incidentFirst[rows]);
+    vector<int> next(incidentFirst.begin(), incidentFirst.end() - 1);
+    for (int c : basic) {
+        for (int k = 0; k < 2; k++) {
+            if (cols[c].row[k] >= 0)
+                incident[next[cols[c].row[k]]++] = c;
+        }
+    }
+
+    order.clear();
+    treeFirst.clear();
+    treeExtra.clear();
+    treeOf.assign(rows, -1);
+    parentCol.assign(rows, -1);
+
+    for (int start = 0; start < rows; start++) {
+        if (treeOf[start] != -1)
+            continue;
+
+        int tree = (int)treeFirst.size();
+        treeFirst.push_back((int)order.size());
+        treeExtra.push_back(-1);
+        treeOf[start] = tree;
+        order.push_back(start);
+
+        for (size_t q = treeFirst[tree]; q < order.size(); q++) {
+            int v = order[q];
+            for (int i = incidentFirst[v]; i < incidentFirst[v + 1]; i++) {
+                int c = incident[i];
+                if (c == parentCol[v])
+                    continue;
+                int w = otherRow(c, v);
+                if (w >= 0 && treeOf[w] == -1) {
+                    treeOf[w] = tree;
+                    parentCol[w] = c;
+                    order.push_back(w);
+                }
+                else {
+                    assert(treeExtra[tree] == -1 || treeExtra[tree] == c);
+                    treeExtra[tree] = c;
+                }
+            }
+        }
+        assert(treeExtra[tree] != -1);
+    }
+    treeFirst.push_back((int)order.size());
+}
+
+
+//
+// findPotentials() - Finds the potential of each row so every basic column
+//          has a reduced cost of 0.  The potentials of a tree are worked out
+//          from its root as a + b * (root potential), and the extra column
+//          gives the root potential.
+//
+void NetworkSimplex::findPotentials(vector<double>& potential) {
+    rowA.assign(rows, 0.0);
+    rowB.assign(rows, 0.0);
+    potential.assign(rows, 0.0);
+
+    for (size_t tree = 0; tree + 1 < treeFirst.size(); tree++) {
+        int root = order[treeFirst[tree]];
+        rowB[root] = 1.0;
+        for (int q = treeFirst[tree] + 1; q < treeFirst[tree + 1]; q++) {
+            int v = order[q];
+            int c = parentCol[v];
+            int p = otherRow(c, v);
+            double cv = coefAt(c, v);
+            double cp = coefAt(c, p);
+            rowA[v] = (cols[c].cost - cp * rowA[p]) / cv;
+            rowB[v] = -cp * rowB[p] / cv;
+        }
+
+        const FlowColumn& extra = cols[treeExtra[tree]];
+        double a = 0.0;
+        double b = 0.0;
+        for (int k = 0; k < 2; k++) {
+            if (extra.row[k] >= 0) {
+                a += extra.coef[k] * rowA[extra.row[k]];
+                b += extra.coef[k] * rowB[extra.row[k]];
+            }
+        }
+        double t = (extra.cost - a) / b;
+        for (int q = treeFirst[tree]; q < treeFirst[tree + 1]; q++)
+            potential[order[q]] = rowA[order[q]] + rowB[order[q]] * t;
+    }
+}
+
+
+//
+// solveTrees() - Finds the flows y of the basic columns of the listed trees
+//          that make up rhs in each row.  The flows are worked out from the
+//          leaves as a + b * (flow of the extra column), and the root's row
+//          gives the flow of the extra column.
+//
+void NetworkSimplex::solveTrees(const vector<double>& rhs, const vector<int>& trees, vector<double>& y) {
+    for (int tree : trees) {
+        for (int q = treeFirst[tree]; q < treeFirst[tree + 1]; q++) {
+            rowA[order[q]] = 0.0;
+            rowB[order[q]] = 0.0;
+        }
+
+        int e = treeExtra[tree];
+        for (int k = 0; k < 2; k++) {
+            if (cols[e].row[k] >= 0)
+                rowB[cols[e].row[k]] += cols[e].coef[k];
+        }
+
+        for (int q = treeFirst[tree + 1] - 1; q > treeFirst[tree]; q--) {
+            int v = order[q];
+            int c = parentCol[v];
+            double cv = coefAt(c, v);
+            colA[c] = (rhs[v] - rowA[v]) / cv;
+            colB[c] = -rowB[v] / cv;
+
+            int p = otherRow(c, v);
+            double cp = coefAt(c, p);
+            rowA[p] += cp * colA[c];
+            rowB[p] += cp * colB[c];
+        }
+
+        int root = order[treeFirst[tree]];
+        double t = (rhs[root] - rowA[root]) / rowB[root];
+        y[e] = t;
+        for (int q = treeFirst[tree] + 1; q < treeFirst[tree + 1]; q++) {
+            int c = parentCol[order[q]];
+            y[c] = colA[c] + colB[c] * t;
+        }
+    }
+}
+
+
+//
+// run() - Pivots until no column lowers the cost (or maxPivots is reached;
+//         the flow is always feasible).  Returns the pivots taken.
+//
+int NetworkSimplex::run(int maxPivots) {
+    vector<double> potential;
+    vector<double> rhs(rows, 0.0);
+    vector<double> y(cols.size(), 0.0);
+    vector<int> trees, moved;
+    int degenerate = 0;
+    int pivots = 0;
+
+    while (pivots < maxPivots) {
+        findTrees();
+        findPotentials(potential);
+
+        // Pricing: the column whose reduced cost gains the most, or the first
+        // one that gains after a run of pivots that moved no flow
+        bool bland = degenerate >= DEGENERATE_PIVOTS;
+        int enter = -1;
+        double best = 0.0;
+        for (int c = 0; c < (int)cols.size(); c++) {
+            if (state[c] == BASIC || cols[c].upper <= MinCostFlow::EPSILON)
+                continue;
+            double reduced = cols[c].cost;
+            for (int k = 0; k < 2; k++) {
+                if (cols[c].row[k] >= 0)
+                    reduced -= cols[c].coef[k] * potential[cols[c].row[k]];
+            }
+            double improvement = state[c] == AT_LOWER ? -reduced : reduced;
+            if (improvement > MinCostFlow::EPSILON * (1.0 + fabs(cols[c].cost)) && improvement > best) {
+                enter = c;
+                best = improvement;
+                if (bland)
+                    break;
+            }
+        }
+        if (enter == -1)
+            break;
+
+        // Flow change of the basic columns for each unit the entering column moves
+        double dir = state[enter] == AT_LOWER ? 1.0 : -1.0;
+        trees.clear();
+        for (int k = 0; k < 2; k++) {
+            int r = cols[enter].row[k];
+            if (r >= 0) {
+                rhs[r] = cols[enter].coef[k];
+                if (find(trees.begin(), trees.end(), treeOf[r]) == trees.end())
+                    trees.push_back(treeOf[r]);
+            }
+        }
+        solveTrees(rhs, trees, y);
+        for (int k = 0; k < 2; k++) {
+            if (cols[enter].row[k] >= 0)
+                rhs[cols[enter].row[k]] = 0.0;
+        }
+
+        moved.clear();
+        for (int tree : trees) {
+            moved.push_back(treeExtra[tree]);
+            for (int q = treeFirst[tree] + 1; q < treeFirst[tree + 1]; q++)
+                moved.push_back(parentCol[order[q]]);
+        }
+
+        // Ratio test: the entering column moves until it or a basic column
+        // reaches a bound
+        double step = cols[enter].upper;
+        int leave = enter;
+        bool leaveAtUpper = dir > 0.0;
+        double leavePivot = 1.0;
+        for (int c : moved) {
+            double change = -dir * y[c];
+            double limit;
+            if (change < -MinCostFlow::EPSILON)
+                limit = x[c] / -change;
+            else if (change > MinCostFlow::EPSILON)
+                limit = (cols[c].upper - x[c]) / change;
+            else
+                continue;
+
+            limit = max(0.0, limit);
+            bool tie = fabs(limit - step) <= MinCostFlow::EPSILON;
+            if ((!tie && limit < step)
+                || (tie && (bland ? c < leave : fabs(change) > leavePivot))) {
+                step = limit;
+                leave = c;
+                leaveAtUpper = change > 0.0;
+                leavePivot = fabs(change);
+            }
+        }
+        if (step == INFINITE_FLOW)
+            break;          // Unbounded: an arc without a limit lowers the cost forever
+
+        x[enter] += dir * step;
+        for (int c : moved)
+            x[c] -= dir * y[c] * step;
+
+        if (leave == enter) {
+            state[enter] = leaveAtUpper ? AT_UPPER : AT_LOWER;
+        }
+        else {
+            x[leave] = leaveAtUpper ? cols[leave].upper : 0.0;
+            state[leave] = leaveAtUpper ? AT_UPPER : AT_LOWER;
+            int slot = basicSlot[leave];
+            basicSlot[leave] = -1;
+            basic[slot] = enter;
+            basicSlot[enter] = slot;
+            state[enter] = BASIC;
+        }
+
+        degenerate = step <= MinCostFlow::EPSILON ? degenerate + 1 : 0;
+        pivots++;
+    }
+
+    // Work out the basic flows again from the columns at their bounds, so
+    // rounding from the pivots does not build up
+    findTrees();
+    for (int c = 0; c < (int)cols.size(); c++) {
+        if (state[c] != BASIC && x[c] != 0.0) {
+            for (int k = 0; k < 2; k++) {
+                if (cols[c].row[k] >= 0)
+                    rhs[cols[c].row[k]] -= cols[c].coef[k] * x[c];
+            }
+        }
+    }
+    trees.clear();
+    for (int tree = 0; tree + 1 < (int)treeFirst.size(); tree++)
+        trees.push_back(tree);
+    solveTrees(rhs, trees, y);
+    for (int c : basic)
+        x[c] = min(max(y[c], 0.0), cols[c].upper);
+
+    return pivots;
+}
+
+
+//
+// addArc() - Adds an arc and returns its id
+//
+int MinCostFlow::addArc(int from, int to, double capacity, double cost, double gain) {
+    assert(from >= 0 && from < nodeCount && to >= 0 && to < nodeCount);
+    arcs.push_back({ from, to, max(0.0, capacity), cost, gain });
+    return (int)arcs.size() - 1;
+}
+
+
+//
+// solve() - Runs the network simplex.  The source and the sink have no row,
+//           as they may send or take any amount.
+//
+double MinCostFlow::solve(int source, int sink, double& totalFlow) {
+    vector<int> rowOf(nodeCount, -1);
+    int rows = 0;
+    for (int v = 0; v < nodeCount; v++) {
+        if (v != source && v != sink)
+            rowOf[v] = rows++;
+    }
+
+    vector<FlowColumn> columns;
+    columns.reserve(arcs.size() + rows);
+    for (const Arc& arc : arcs) {
+        FlowColumn col = { { -1, -1 }, { 0.0, 0.0 }, arc.capacity, arc.cost };
+        int tail = rowOf[arc.from];
+        int head = rowOf[arc.to];
+        int k = 0;
+        if (tail >= 0 && tail == head) {
+            if (arc.gain != 1.0) {                      // A loop keeps or loses flow
+                col.row[k] = tail;
+                col.coef[k++] = 1.0 - arc.gain;
+            }
+        }
+        else {
+            if (tail >= 0) {
+                col.row[k] = tail;
+                col.coef[k++] = 1.0;
+            }
+            if (head >= 0 && arc.gain != 0.0) {
+                col.row[k] = head;
+                col.coef[k++] = -arc.gain;
+            }
+        }
+        columns.push_back(col);
+    }
+    for (int r = 0; r < rows; r++)
+        columns.push_back({ { r, -1 }, { 1.0, 0.0 }, 0.0, 0.0 });
+
+    NetworkSimplex simplex(rows, columns);
+    pivots = simplex.run(100 * (int)(arcs.size() + rows) + 1000);
+
+    double totalCost = 0.0;
+    totalFlow = 0.0;
+    flow.resize(arcs.size());
+    for (size_t a = 0; a < arcs.size(); a++) {
+        flow[a] = simplex.getValue((int)a);
+        totalCost += flow[a] * arcs[a].cost;
+        if (arcs[a].from == source)
+            totalFlow += flow[a];
+        if (arcs[a].to == source)
+            totalFlow -= flow[a] * arcs[a].gain;
+    }
+    return totalCost;
+}
@@ -0,0 +1,78 @@
+// File: NameTable.cpp
+//
+// Contains the function definitions for the NameTable class (see NameTable.h)
+//
+#include <cassert>
+#include "../header/NameTable.h"
+
+using namespace std;
+
+//
+// intern() - Returns the id of a name.  A new name is copied into the next
+//            free slot of the last chunk (a chunk is added when it is full).
+//
+NameID NameTable::intern(string_view name) {
+    if (!imageIndexed)
+        indexImageNames();
+
+    auto it = idsByName.find(name);
+    if (it != idsByName.end())
+        return it->second;
+
+    NameID id = (NameID)nameCount;
+    size_t stored = nameCount - imageCount;
+    if (stored % CHUNK_SIZE == 0)
+        chunks.emplace_back(new string[CHUNK_SIZE]);
+
+    string& text = chunks[stored / CHUNK_SIZE][stored % CHUNK_SIZE];
+    text.assign(name.data(), name.size());
+    idsByName.emplace(string_view(text), id);
+
+    nameCount++;
+    return id;
+}
+
+
+//
+// find() - Looks up the id of a name without adding it
+//
+bool NameTable::find(string_view name, NameID& id) const {
+    if (!imageIndexed)
+        indexImageNames();
+
+    auto it = idsByName.find(name);
+    if (it == idsByName.end())
+        return false;
+
+    id = it->second;
+    return true;
+}
+
+
+//
+// adoptImageNames() - Makes the names of a grid image the first names of
+//            the table.  The table keeps the mapping open and reads the
+//            names from it.
+//
+void NameTable::adoptImageNames(unique_ptr<MappedFile> pFile, const char* pText, const ImageString* pNames, size_t count) {
+    assert(nameCount == 0);
+
+    imageFile = move(pFile);
+    pImageText = pText;
+    pImageNames = pNames;
+    imageCount = count;
+    nameCount = count;
+    imageIndexed = count == 0;
+}
+
+
+//
+// indexImageNames() - Adds the image names to the lookup by name (the first
+//            time a name is looked up)
+//
+void NameTable::indexImageNames() const {
+    idsByName.reserve(nameCount);
+    for (size_t i = 0; i < imageCount; i++)
+        idsByName.emplace(view((NameID)i), (NameID)i);
+    imageIndexed = true;
+}
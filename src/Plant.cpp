@@ -8,6 +8,37 @@
 #include <cassert>
 #include "../header/GridDef.h"
 #include "../header/Plant.h"
+#include "../header/PlantStore.h"
+
+//
+// plantTypeName() - Returns the text of a plant type as it appears in the data files
+//
+string_view plantTypeName(PlantType type) {
+    switch (type) {
+    case PlantType::Solar:      return PT_SOLAR;
+    case PlantType::Wind:       return PT_WIND;
+    case PlantType::Hydro:      return PT_HYDRO;
+    case PlantType::Nuclear:    return PT_NUCLEAR;
+    case PlantType::Geothermal: return PT_GEOTHERMAL;
+    case PlantType::Gas:        return PT_GAS;
+    }
+    return string_view();
+}
+
+//
+// plantTypeFromName() - Finds the plant type for its text in the data files
+//
+bool plantTypeFromName(string_view name, PlantType& type) {
+    if (name == PT_SOLAR)           type = PlantType::Solar;
+    else if (name == PT_WIND)       type = PlantType::Wind;
+    else if (name == PT_HYDRO)      type = PlantType::Hydro;
+    else if (name == PT_NUCLEAR)    type = PlantType::Nuclear;
+    else if (name == PT_GEOTHERMAL) type = PlantType::Geothermal;
+    else if (name == PT_GAS)        type = PlantType::Gas;
+    else
+        return false;
+    return true;
+}
 
 //
 // reduceCapacity() - reduces available capacity of a plant 
@@ -16,14 +47,100 @@ void PowerPlant::reduceCapacity(double amount) {
     //assert(amount <= availableCapacity);
     if (amount <= availableCapacity) {
         availableCapacity -= amount; // Reduces the available output or capacity
+        capacityAllocated += amount;
+        capacityChanged();
     }
 }
 
+//
+// releaseCapacity() - gives back capacity that was allocated to an area
+//
+void PowerPlant::releaseCapacity(double amount) {
+    capacityAllocated = max(0.0, capacityAllocated - amount);
+    availableCapacity = max(0.0, currentOutput - capacityAllocated);
+    capacityChanged();
+}
+
+//
+// resetCapacity() - releases everything allocated from the plant
+//
+void PowerPlant::resetCapacity() {
+    availableCapacity = currentOutput;
+    capacityAllocated = 0.0;
+    capacityChanged();
+}
+
+//
+// saveState() - copies the state that changes while the grid is modeled
+//
+void PowerPlant::saveState(PlantState& state) const {
+    getRatingInputs(state.input1, state.input2);
+    state.currentOutput = currentOutput;
+    state.availableCapacity = availableCapacity;
+    state.capacityAllocated = capacityAllocated;
+    state.ratingStale = ratingStale;
+    state.online = online;
+    state.dirty = links.dirty;
+}
+
+//
+// restoreState() - puts back a state copied by saveState.  The plant store
+//          (if any) gets the restored rating inputs.
+//
+void PowerPlant::restoreState(const PlantState& state) {
+    setRatingInputs(state.input1, state.input2);
+    online = state.online;
+    if (links.pStore != nullptr)
+        links.pStore->refreshInputs(this, links.storeGroup, links.storeRow);
+
+    currentOutput = state.currentOutput;
+    availableCapacity = state.availableCapacity;
+    capacityAllocated = state.capacityAllocated;
+    ratingStale = state.ratingStale;
+    links.dirty = state.dirty;
+}
+
+//
+// applyRatedOutput() - Sets the current output of the plant for its current
+//          conditions.  The power already allocated to areas stays
+//          allocated, and the rest of the output is available.  If the new
+//          output is less than what is allocated, none is available and the
+//          plant stays over-allocated until the grid moves the excess (see
+//          adjustPlantsForConditions).  An offline plant has no output.
+//
+void PowerPlant::applyRatedOutput(double output) {
+    currentOutput = online ? output : 0.0;
+    availableCapacity = max(0.0, currentOutput - capacityAllocated);
+    ratingStale = false;
+    capacityChanged();
+}
+
+
+//
+// inputsChanged() - Called when a rating input of the plant is changed so
+//          the copy in the plant store (if any) stays the same as the plant,
+//          and the grid (if any) knows to rate and re-dispatch the plant
+//
+void PowerPlant::inputsChanged() {
+    if (links.pStore != nullptr)
+        links.pStore->refreshInputs(this, links.storeGroup, links.storeRow);
+
+    if (links.pUnratedList != nullptr && !ratingStale)
+        links.pUnratedList->push_back(links.gridSlot);
+    ratingStale = true;
+
+    if (links.pDirtyList != nullptr && !links.dirty) {
+        links.dirty = true;
+        links.pDirtyList->push_back(links.gridSlot);
+    }
+}
+
+
 //
 // getCapacityAllocated()  -  Returns power capacity already allocated to areas
 //
 double PowerPlant::getCapacityAllocated() const { 
-    return currentOutput - availableCapacity;
+    return capacityAllocated;
 }
 
 
@@ -45,8 +162,7 @@ double  PowerPlant::getCostOfAllocatedPower() const {
 //
 double SolarFarm::calculateOutput() {
     // Calculate and set the current output of this plant
-    currentOutput = numAcres * sunlightHours / 55;
-    availableCapacity = currentOutput;
+    applyRatedOutput(outputFor(numAcres, sunlightHours));
     return currentOutput;
 }
 
@@ -54,7 +170,7 @@ double SolarFarm::calculateOutput() {
 //
 // getCurCondtions():  Returns the current conditons at the plant
 // 
-string SolarFarm::getCurrentCondition() const {
+string SolarFarm::getCurrentCondition(const NameTable& names) const {
     stringstream oss;
     oss << "Number of Acres: " << numAcres <<
         ", Sunlight: " << sunlightHours << " Hrs";
@@ -79,8 +195,7 @@ string SolarFarm::getCurrentCondition() const {
 //
 
 double WindFarm::calculateOutput() {
-    currentOutput = turbineCount * avgWindSpeed / 9.8;
-    availableCapacity = currentOutput;
+    applyRatedOutput(outputFor(turbineCount, avgWindSpeed));
     return currentOutput;
 }
 
@@ -88,7 +203,7 @@ double WindFarm::calculateOutput() {
 //
 // getCurCondtions():  Returns the current conditions at the plant
 // 
-string WindFarm::getCurrentCondition() const {
+string WindFarm::getCurrentCondition(const NameTable& names) const {
     stringstream oss;
     oss << "# Turbines: " << turbineCount
         << ", Blade Len: " << bladeLength
@@ -105,15 +220,14 @@ string WindFarm::getCurrentCondition() const {
 // This adjusts the available capacity of the plant based on the factors unique to this plant
 //
 double HydroPlant::calculateOutput() {
-    currentOutput = inFlowRate * verticalDrop / 600;
-    availableCapacity = currentOutput;
+    applyRatedOutput(outputFor(inFlowRate, verticalDrop));
     return currentOutput;
 }
 
 //
 // getCurCondtions():  Returns the current conditions at the plant
 // 
-string HydroPlant::getCurrentCondition() const {
+string HydroPlant::getCurrentCondition(const NameTable& names) const {
     stringstream oss;
     oss << std::fixed << std::setprecision(2) <<
         "Water Flow: " << inFlowRate << " m3/s"
@@ -132,15 +246,14 @@ string HydroPlant::getCurrentCondition() const {
 // This adjusts the available capacity of the plant based on the factors unique to this plant
 //
 double NuclearPlant::calculateOutput() {
-    currentOutput = fuelRodsActive * 20;
-    availableCapacity = currentOutput;
+    applyRatedOutput(outputFor(fuelRodsActive));
     return currentOutput;
 }
 
 //
 // getCurCondtions():  Returns the current conditions at the plant
 // 
-string NuclearPlant::getCurrentCondition() const {
+string NuclearPlant::getCurrentCondition(const NameTable& names) const {
     stringstream oss;
     oss << "Number of fuels rods active: " << fuelRodsActive;
     return oss.str();
@@ -156,15 +269,14 @@ string NuclearPlant::getCurrentCondition() const {
 //
 double GeothermalPlant::calculateOutput() {
     // Stable output, just use max
-    currentOutput = maxPowerOutput;
-    availableCapacity = currentOutput;
+    applyRatedOutput(outputFor(maxPowerOutput));
     return currentOutput;
 }
 
 //
 // getCurCondtions():  Returns the current conditons at the plant
 //
-string GeothermalPlant::getCurrentCondition() const {
+string GeothermalPlant::getCurrentCondition(const NameTable& names) const {
     return "Geothermal conditions normal";
 }
 
@@ -177,16 +289,15 @@ string GeothermalPlant::getCurrentCondition() const {
 // This adjusts the available capacity of the plant based on the factors unique to this plant
 //
 double GasPlant::calculateOutput() {
-    currentOutput = maxPowerOutput * throttlePercent / 100.0;
-    availableCapacity = currentOutput;
+    applyRatedOutput(outputFor(maxPowerOutput, throttlePercent));
     return currentOutput;
 }
 
 //
 // getCurCondtions():  Returns the current conditons at the plant
 // 
-string GasPlant::getCurrentCondition() const {
+string GasPlant::getCurrentCondition(const NameTable& names) const {
     stringstream oss;
-    oss << "Fuel Type: " << fuelType << ", Throttle open %: " << throttlePercent;
+    oss << "Fuel Type: " << getFuelType(names) << ", Throttle open %: " << throttlePercent;
     return oss.str();
 }
\ No newline at end of file
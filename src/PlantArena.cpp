@@ -0,0 +1,92 @@
+// File: PlantArena.cpp
+//
+// Contains the function definitions for the PlantArena class (see PlantArena.h)
+//
+#include "../header/PlantArena.h"
+
+using namespace std;
+
+//
+// allocate() - Returns memory for one object from the current block.  A new
+//          block is started when the current one is full.  An object larger
+//          than a block gets a block of its own.
+//
+void* PlantArena::allocate(size_t size, size_t alignment) {
+    size_t offset = (blockUsed + alignment - 1) & ~(alignment - 1);
+
+    if (blocks.empty() || offset + size > blockSize) {
+        blockSize = max(PLANT_ARENA_BLOCK_SIZE, size + alignment);
+        blocks.push_back(unique_ptr<char[]>(new char[blockSize]));
+        blockUsed = 0;
+
+        // new[] memory is aligned for any standard type, align from the start
+        offset = 0;
+    }
+
+    blockUsed = offset + size;
+    return blocks.back().get() + offset;
+}
+
+
+//
+// adopt() - Moves the plants and blocks of another arena into this one.  The
+//          other arena is left empty.  New plants continue in a fresh block.
+//
+void PlantArena::adopt(PlantArena& other) {
+    if (other.blocks.empty())
+        return;
+
+    // The blocks of the other arena go before this arena's current block so
+    // this arena keeps filling the block it was using
+    unique_ptr<char[]> current;
+    if (!blocks.empty()) {
+        current = move(blocks.back());
+        blocks.pop_back();
+    }
+    for (auto& block : other.blocks)
+        blocks.push_back(move(block));
+    if (current) {
+        blocks.push_back(move(current));
+    }
+    else {
+        blockUsed = other.blockUsed;
+        blockSize = other.blockSize;
+    }
+
+    objects.insert(objects.end(), other.objects.begin(), other.objects.end());
+
+    other.blocks.clear();
+    other.objects.clear();
+    other.blockUsed = 0;
+    other.blockSize = 0;
+}
+
+
+//
+// clone() - Copies a plant into the arena.  The copy starts out unconnected
+//           from the grid's helpers (see PowerPlant::PlantLinks).
+//
+PowerPlant* PlantArena::clone(const PowerPlant& plant) {
+    switch (plant.getPlantType()) {
+    case PlantType::Solar:      return create<SolarFarm>(static_cast<const SolarFarm&>(plant));
+    case PlantType::Wind:       return create<WindFarm>(static_cast<const WindFarm&>(plant));
+    case PlantType::Hydro:      return create<HydroPlant>(static_cast<const HydroPlant&>(plant));
+    case PlantType::Nuclear:    return create<NuclearPlant>(static_cast<const NuclearPlant&>(plant));
+    case PlantType::Geothermal: return create<GeothermalPlant>(static_cast<const GeothermalPlant&>(plant));
+    case PlantType::Gas:        return create<GasPlant>(static_cast<const GasPlant&>(plant));
+    }
+    return nullptr;
+}
+
+//
+// release() - Destroys every plant (newest first) and frees the blocks
+//
+void PlantArena::release() {
+    for (auto it = objects.rbegin(); it != objects.rend(); ++it)
+        (*it)->~PowerPlant();
+
+    objects.clear();
+    blocks.clear();
+    blockUsed = 0;
+    blockSize = 0;
+}
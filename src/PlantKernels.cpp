@@ -0,0 +1,166 @@
+// File: PlantKernels.cpp
+//
+// Contains the batch plant output functions (see PlantKernels.h).
+//
+// There is one kernel for each instruction set.  The best kernel for the
+// CPU is chosen the first time a batch function is called.
+//
+#include "../header/PlantKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PLANT_KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang need to be told a function may use AVX2 instructions
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define TARGET_AVX2
+#define TARGET_SSE2
+#endif
+
+// Kernel signature:  output[i] = a[i] * b[i] / divisor
+typedef void (*MulDivKernel)(const double* a, const double* b, double divisor, double* output, size_t count);
+
+
+//
+// mulDivScalar() - Plain C++ version, used on any CPU
+//
+static void mulDivScalar(const double* a, const double* b, double divisor, double* output, size_t count) {
+    for (size_t i = 0; i < count; i++)
+        output[i] = a[i] * b[i] / divisor;
+}
+
+
+#ifdef PLANT_KERNELS_X86
+//
+// mulDivSSE2() - Two plants at a time
+//
+TARGET_SSE2
+static void mulDivSSE2(const double* a, const double* b, double divisor, double* output, size_t count) {
+    __m128d vDivisor = _mm_set1_pd(divisor);
+    size_t i = 0;
+
+    for (; i + 2 <= count; i += 2) {
+        __m128d product = _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+        _mm_storeu_pd(output + i, _mm_div_pd(product, vDivisor));
+    }
+    mulDivScalar(a + i, b + i, divisor, output + i, count - i);
+}
+
+
+//
+// mulDivAVX2() - Four plants at a time, unrolled to eight
+//
+TARGET_AVX2
+static void mulDivAVX2(const double* a, const double* b, double divisor, double* output, size_t count) {
+    __m256d vDivisor = _mm256_set1_pd(divisor);
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256d product0 = _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+        __m256d product1 = _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4));
+        _mm256_storeu_pd(output + i, _mm256_div_pd(product0, vDivisor));
+        _mm256_storeu_pd(output + i + 4, _mm256_div_pd(product1, vDivisor));
+    }
+    for (; i + 4 <= count; i += 4) {
+        __m256d product = _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+        _mm256_storeu_pd(output + i, _mm256_div_pd(product, vDivisor));
+    }
+    mulDivScalar(a + i, b + i, divisor, output + i, count - i);
+}
+
+
+//
+// cpuHasAVX2() - Checks if the CPU (and operating system) support AVX2
+//
+static bool cpuHasAVX2() {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    // AVX2 needs the OS to save the AVX registers (OSXSAVE and XCR0 bits)
+    __cpuid(info, 1);
+    bool osSavesAVX = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    return osSavesAVX && (info[1] & (1 << 5));
+#else
+    return false;
+#endif
+}
+
+
+//
+// cpuHasSSE2() - Checks if the CPU supports SSE2 (every 64 bit x86 CPU does,
+//                a 32 bit one may not)
+//
+static bool cpuHasSSE2() {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return false;
+#endif
+}
+#endif
+
+
+//
+// Kernel chosen for this CPU.  A function local static is set up once and
+// is safe to use from any thread.
+//
+struct KernelChoice {
+    MulDivKernel    mulDiv;
+    const char*     target;
+};
+
+static const KernelChoice& kernelChoice() {
+    static const KernelChoice choice = []() {
+#ifdef PLANT_KERNELS_X86
+        if (cpuHasAVX2())
+            return KernelChoice{ mulDivAVX2, "avx2" };
+        if (cpuHasSSE2())
+            return KernelChoice{ mulDivSSE2, "sse2" };
+#endif
+        return KernelChoice{ mulDivScalar, "scalar" };
+    }();
+    return choice;
+}
+
+
+//
+// Batch output functions for each plant type
+//
+void rateSolarBatch(const double* acres, const double* sunlightHours, double* output, size_t count) {
+    kernelChoice().mulDiv(acres, sunlightHours, 55, output, count);
+}
+
+void rateWindBatch(const double* turbines, const double* windSpeed, double* output, size_t count) {
+    kernelChoice().mulDiv(turbines, windSpeed, 9.8, output, count);
+}
+
+void rateHydroBatch(const double* flowRate, const double* drop, double* output, size_t count) {
+    kernelChoice().mulDiv(flowRate, drop, 600, output, count);
+}
+
+void rateGasBatch(const double* maxOutput, const double* throttlePercent, double* output, size_t count) {
+    kernelChoice().mulDiv(maxOutput, throttlePercent, 100.0, output, count);
+}
+
+const char* plantKernelTarget() {
+    return kernelChoice().target;
+}
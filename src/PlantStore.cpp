@@ -0,0 +1,140 @@
+// File: PlantStore.cpp
+//
+// Contains the function definitions for the struct-of-arrays plant store
+// (see PlantStore.h).
+//
+#include "../header/PlantStore.h"
+#include "../header/PlantKernels.h"
+
+using namespace std;
+
+//
+// groupForType() - Returns the store group for a plant type
+//
+int PlantStore::groupForType(PlantType type) {
+    switch (type) {
+    case PlantType::Solar:      return GROUP_SOLAR;
+    case PlantType::Wind:       return GROUP_WIND;
+    case PlantType::Hydro:      return GROUP_HYDRO;
+    case PlantType::Nuclear:    return GROUP_NUCLEAR;
+    case PlantType::Geothermal: return GROUP_GEOTHERMAL;
+    case PlantType::Gas:        return GROUP_GAS;
+    }
+    return -1;
+}
+
+
+//
+// build() - Copies the plants into the columns of their group and attaches
+//           each plant to its row
+//
+void PlantStore::build(const vector<PowerPlant*>& plants) {
+    clear();
+
+    for (auto pPlant : plants) {
+        int group = groupForType(pPlant->getPlantType());
+        if (group < 0)
+            continue;       // Unknown plants are rated by their own calculateOutput
+
+        PlantGroup& columns = groups[group];
+        double input1, input2;
+        pPlant->getRatingInputs(input1, input2);
+
+        pPlant->attachStore(this, group, columns.size());
+        columns.plants.push_back(pPlant);
+        columns.maxOutput.push_back(pPlant->getMaxPowerOutput());
+        columns.operatingCost.push_back(pPlant->getOperatingCost());
+        columns.input1.push_back(input1);
+        columns.input2.push_back(input2);
+        columns.online.push_back(pPlant->isOnline() ? 1.0 : 0.0);
+        columns.currentOutput.push_back(pPlant->getCurrentOutput());
+    }
+}
+
+
+//
+// clear() - Detaches the plants and empties every group
+//
+void PlantStore::clear() {
+    for (auto& columns : groups) {
+        for (auto pPlant : columns.plants)
+            pPlant->attachStore(nullptr, 0, 0);
+
+        columns = PlantGroup();
+    }
+}
+
+
+//
+// size() - Returns the number of plants in the store
+//
+size_t PlantStore::size() const {
+    size_t count = 0;
+    for (const auto& columns : groups)
+        count += columns.size();
+    return count;
+}
+
+
+//
+// refreshInputs() - Copies the rating inputs of a plant, and whether it is
+//             online, into its row
+//
+void PlantStore::refreshInputs(const PowerPlant* pPlant, int group, size_t row) {
+    PlantGroup& columns = groups[group];
+    pPlant->getRatingInputs(columns.input1[row], columns.input2[row]);
+    columns.online[row] = pPlant->isOnline() ? 1.0 : 0.0;
+}
+
+
+//
+// rateAll() - Recalculates the output of every plant.  Each group is done
+//             in one batch over its columns using the formula of its class.
+//             Solar, wind, hydro, and gas use the vectorized batch functions.
+//             The output of a plant that is offline is 0.
+//
+void PlantStore::rateAll() {
+    PlantGroup& solar = groups[GROUP_SOLAR];
+    rateSolarBatch(solar.input1.data(), solar.input2.data(), solar.currentOutput.data(), solar.size());
+
+    PlantGroup& wind = groups[GROUP_WIND];
+    rateWindBatch(wind.input1.data(), wind.input2.data(), wind.currentOutput.data(), wind.size());
+
+    PlantGroup& hydro = groups[GROUP_HYDRO];
+    rateHydroBatch(hydro.input1.data(), hydro.input2.data(), hydro.currentOutput.data(), hydro.size());
+
+    PlantGroup& gas = groups[GROUP_GAS];
+    rateGasBatch(gas.maxOutput.data(), gas.input1.data(), gas.currentOutput.data(), gas.size());
+
+    PlantGroup& nuclear = groups[GROUP_NUCLEAR];
+    for (size_t i = 0; i < nuclear.size(); i++)
+        nuclear.currentOutput[i] = NuclearPlant::outputFor((int)nuclear.input1[i]);
+
+    PlantGroup& geothermal = groups[GROUP_GEOTHERMAL];
+    for (size_t i = 0; i < geothermal.size(); i++)
+        geothermal.currentOutput[i] = GeothermalPlant::outputFor(geothermal.maxOutput[i]);
+
+    for (auto& columns : groups) {
+        for (size_t i = 0; i < columns.size(); i++)
+            columns.currentOutput[i] *= columns.online[i];
+    }
+}
+
+
+//
+// applyToPlants() - Writes the calculated outputs back to the plant objects
+//             whose rating inputs changed since they were last rated
+//
+double PlantStore::applyToPlants() {
+    double change = 0.0;
+    for (auto& columns : groups) {
+        for (size_t i = 0; i < columns.size(); i++) {
+            PowerPlant* pPlant = columns.plants[i];
+            if (pPlant->isRatingStale()) {
+                change += columns.currentOutput[i] - pPlant->getCurrentOutput();
+                pPlant->applyRatedOutput(columns.currentOutput[i]);
+            }
+        }
+    }
+    return change;
+}
@@ -0,0 +1,251 @@
+// File: PlantStream.cpp
+//
+// Contains the functions to parse plant records and to stream large plant
+// data files in fixed size chunks (see PlantStream.h).
+//
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include "../header/PlantStream.h"
+#include "../header/Plant.h"
+
+using namespace std;
+
+//
+// parsePlantEntry() - Reads one plant record.  The plant name may be multiple
+//          words and is terminated by a comma.  The first 3 fields are common
+//          to all plants, the rest depend on the type of plant.  The rest of
+//          the line of a plant of an unknown type is skipped, so the next
+//          record is read from the start of the next line.
+//
+PlantParseStatus parsePlantEntry(TextScanner& scanner, PlantEntry& entry) {
+
+    if (!scanner.readUntil(',', entry.name))
+        return PLANT_PARSE_END;
+
+    entry.type = scanner.nextToken();
+    if (!scanner.nextDouble(entry.maxOutput) || !scanner.nextDouble(entry.operatingCost))
+        return PLANT_PARSE_END;
+
+    entry.fuelType = string_view();
+    entry.param1 = 0.0;
+    entry.param2 = 0.0;
+    entry.intParam = 0;
+
+    bool ok;
+    if (entry.type == PT_SOLAR)
+        ok = scanner.nextDouble(entry.param1) && scanner.nextDouble(entry.param2);
+    else if (entry.type == PT_WIND)
+        ok = scanner.nextInt(entry.intParam) && scanner.nextDouble(entry.param1) && scanner.nextDouble(entry.param2);
+    else if (entry.type == PT_HYDRO)
+        ok = scanner.nextDouble(entry.param1) && scanner.nextDouble(entry.param2);
+    else if (entry.type == PT_NUCLEAR)
+        ok = scanner.nextInt(entry.intParam);
+    else if (entry.type == PT_GEOTHERMAL)
+        ok = true;
+    else if (entry.type == PT_GAS) {
+        entry.fuelType = scanner.nextToken();
+        ok = !entry.fuelType.empty() && scanner.nextDouble(entry.param1);
+    }
+    else {
+        scanner.nextLine();
+        return PLANT_PARSE_BAD_TYPE;
+    }
+
+    return ok ? PLANT_PARSE_OK : PLANT_PARSE_END;
+}
+
+
+//
+// ratePlantEntry() - Returns the output of the plant using the same formula
+//          as the calculateOutput function of its plant class
+//
+double ratePlantEntry(const PlantEntry& entry) {
+    if (entry.type == PT_SOLAR)      return SolarFarm::outputFor(entry.param1, entry.param2);
+    if (entry.type == PT_WIND)       return WindFarm::outputFor(entry.intParam, entry.param2);
+    if (entry.type == PT_HYDRO)      return HydroPlant::outputFor(entry.param1, entry.param2);
+    if (entry.type == PT_NUCLEAR)    return NuclearPlant::outputFor(entry.intParam);
+    if (entry.type == PT_GEOTHERMAL) return GeothermalPlant::outputFor(entry.maxOutput);
+    if (entry.type == PT_GAS)        return GasPlant::outputFor(entry.maxOutput, entry.param1);
+    return 0.0;
+}
+
+
+//
+// streamPlantFile() - Reads a plant file chunkBytes at a time.  Only whole
+//          lines are parsed; a partial line at the end of a chunk is moved to
+//          the front of the buffer and finished by the next read.  The buffer
+//          only grows if a single line is longer than the chunk size.
+//
+int streamPlantFile(const string& filename, const function<void(const vector<PlantEntry>&)>& onBatch,
+                    size_t chunkBytes, size_t batchSize) {
+
+    ifstream isPlant(filename, ios::binary);
+    if (!isPlant) {
+        cerr << "Error: Unable to open Plant file " << filename << endl;
+        return -1;
+    }
+
+    vector<char>        buffer(max(chunkBytes, size_t(64)));
+    size_t              used = 0;           // Bytes of the buffer holding file data
+    bool                atEOF = false;
+    bool                headerDone = false;
+    vector<PlantEntry>  batch;
+    batch.reserve(max(batchSize, size_t(1)));
+
+    // Lambda function to hand the current batch to the callback
+    auto flushBatch = [&]() {
+        if (!batch.empty()) {
+            onBatch(batch);
+            batch.clear();
+        }
+    };
+
+    while (true) {
+        // Fill the rest of the buffer from the file
+        if (!atEOF) {
+            isPlant.read(buffer.data() + used, streamsize(buffer.size() - used));
+            used += size_t(isPlant.gcount());
+            atEOF = isPlant.eof();
+            if (!atEOF && !isPlant) {
+                cerr << "Error: Unable to read Plant file " << filename << endl;
+                return -1;
+            }
+        }
+
+        // Find the end of the last complete line in the buffer
+        size_t end = used;
+        if (!atEOF) {
+            const char* pLast = nullptr;
+            for (size_t i = used; i > 0; i--) {
+                if (buffer[i - 1] == '\n') {
+                    pLast = &buffer[i - 1];
+                    break;
+                }
+            }
+
+            if (pLast == nullptr) {
+                // No complete line yet - the line is longer than the buffer
+                if (used == buffer.size())
+                    buffer.resize(buffer.size() * 2);
+                continue;
+            }
+            end = size_t(pLast - buffer.data()) + 1;
+        }
+
+        // Parse each complete line
+        TextScanner scanChunk(string_view(buffer.data(), end));
+        while (!scanChunk.atEnd()) {
+            string_view line = scanChunk.nextLine();
+
+            // Skip the informational header lines at start of file
+            if (!headerDone) {
+                TextScanner scanHeader(line);
+                headerDone = scanHeader.nextToken() == FILE_HEADER_DELIMITER && scanHeader.nextToken().empty();
+                continue;
+            }
+
+            TextScanner scanLine(line);
+            PlantEntry  entry;
+            PlantParseStatus status = parsePlantEntry(scanLine, entry);
+
+            if (status == PLANT_PARSE_OK) {
+                batch.push_back(entry);
+                if (batch.size() >= batchSize)
+                    flushBatch();
+            }
+            else if (status == PLANT_PARSE_BAD_TYPE) {
+                cerr << "\nUnkown plant type found: " << entry.type << endl;
+            }
+        }
+
+        // The entries point into the buffer so they must be used before it is reused
+        flushBatch();
+
+        if (atEOF)
+            break;
+
+        // Move the partial line to the front of the buffer
+        memmove(buffer.data(), buffer.data() + end, used - end);
+        used -= end;
+    }
+
+    if (!headerDone) {
+        cerr << "Error: No header delimiter found in Plant file " << filename << endl;
+        return -1;
+    }
+    return 0;
+}
+
+
+
+//********************************************************
+//*****          Plant Statistics Aggregator         *****
+//********************************************************
+
+//
+// addToStats() - Adds one plant to a set of statistics
+//
+void PlantStatsAggregator::addToStats(TypeStats& stats, double maxCapacity, double output, double cost) {
+    if (stats.count == 0) {
+        stats.minOutput = output;
+        stats.maxOutput = output;
+    }
+    else {
+        stats.minOutput = min(stats.minOutput, output);
+        stats.maxOutput = max(stats.maxOutput, output);
+    }
+
+    stats.count++;
+    stats.maxCapacity += maxCapacity;
+    stats.ratedOutput += output;
+    stats.costWeighted += cost * output;
+}
+
+
+//
+// addBatch() - Adds a batch of plants to the statistics
+//
+void PlantStatsAggregator::addBatch(const vector<PlantEntry>& batch) {
+    for (const auto& entry : batch) {
+        double output = ratePlantEntry(entry);
+
+        // Find the statistics for this type (only a new type allocates a key)
+        auto it = typeStats.find(entry.type);
+        if (it == typeStats.end())
+            it = typeStats.emplace(string(entry.type), TypeStats()).first;
+
+        addToStats(it->second, entry.maxOutput, output, entry.operatingCost);
+        addToStats(totals, entry.maxOutput, output, entry.operatingCost);
+    }
+}
+
+
+//
+// printReport() - Prints the statistics for each type of plant and the totals
+//
+void PlantStatsAggregator::printReport() const {
+
+    // Lambda function to print one row of the report
+    auto printRow = [](const string& label, const TypeStats& stats) {
+        double avgCost = stats.ratedOutput > 0 ? stats.costWeighted / stats.ratedOutput : 0.0;
+
+        cout << setw(10) << left << label << "   "
+            << setw(9) << right << stats.count << "   "
+            << fixed << setprecision(2) << setw(12) << right << stats.maxCapacity << "   "
+            << setw(12) << right << stats.ratedOutput << "   "
+            << setw(9) << right << stats.minOutput << "   "
+            << setw(9) << right << stats.maxOutput << "   "
+            << setw(9) << right << avgCost << endl;
+    };
+
+    cout << "   Type          Count        Max Cap      Rated Cap     Min Out     Max Out   Avg Cost\n";
+    cout << "----------   ---------   ------------   ------------   ---------   ---------   ---------\n";
+
+    for (const auto& type : typeStats) {
+        printRow(type.first, type.second);
+    }
+    printRow("Total", totals);
+}
@@ -13,6 +13,7 @@
 //            DistributePower.cpp: Contains the function(s) to perform the modeling algorithim.
 // 
 #include <cassert>
+#include <algorithm>
 #include "../header/PowerGrid.h"
 
 using namespace std;
@@ -22,6 +23,10 @@ using namespace std;
 //********************************************************
 int PowerGrid::plantCount = 0;
 
+// The plant store rates every plant in a batch, which is only worth it when at
+// least 1 in STORE_BATCH_FRACTION plants need rating
+const size_t STORE_BATCH_FRACTION = 4;
+
 
 //********************************************************
 //*****        Functions for Power Plants            *****
@@ -30,26 +35,195 @@ int PowerGrid::plantCount = 0;
 //
 // addPlantToGrid() Adds a new plant to the grid.  
 //          Receives a reference to a plant object and places it plant vector 
+//          The grid only frees plants created in its own plant arena, a plant
+//          created anywhere else is still owned by the caller.
 //
 void PowerGrid::addPlantToGrid(PowerPlant* pPlant) {
     // Insert the pointer to the plant into the vector and increment count
     plants.push_back(pPlant);
     plantCount++;
+
+    // Track the plant's allocations and changes to its inputs.  A plant is
+    // rated by the next adjustPlantsForConditions.
+    pPlant->attachGridLists(&dirtyPlants, &unratedPlants, plants.size() - 1);
+    plantAllocations.push_back(NO_ALLOCATION);
+    if (isBranch())
+        plantShared.push_back(0);
+    ratedOutputTotal += pPlant->getCurrentOutput();
+    if (pPlant->isRatingStale())
+        unratedPlants.push_back(plants.size() - 1);
+
+    // The plant store and the capacity index must be rebuilt to include the new plant
+    plantStoreStale = true;
+    plantIndexStale = true;
+    dispatchLPStale = true;
+}
+
+//
+// clearGrid():  Removes every plant, area, and line from the grid.  All of
+//          the plants in the grid's arena are freed at once, and so are the
+//          names (unless a branch still shares the table).
+//
+void PowerGrid::clearGrid() {
+    plantStore.clear();
+    plantStoreStale = true;
+    clearAllocationLedger();
+    for (size_t i = 0; i < plants.size(); i++) {
+        if (isPlantShared(i))
+            continue;       // Still connected to the grid this branch was made from
+        plants[i]->attachIndex(nullptr, 0);
+        plants[i]->attachGridLists(nullptr, nullptr, 0);
+    }
+    plantIndex.clear();
+    plantIndexStale = true;
+    plantAllocations.clear();
+    lineAllocations.clear();
+    areaAllocations.clear();
+    unratedPlants.clear();
+    ratedOutputTotal = 0.0;
+    baseline.saved = false;
+
+    if (plants.size() > inheritedPlantCount)
+        plantCount -= (int)(plants.size() - inheritedPlantCount);     // Only the plants added to this grid were counted
+    plants.clear();
+    plantShared.clear();
+    inheritedPlantCount = 0;
+    plantArena.release();
+
+    areaQueue.clear();
+    areaQueueStale = true;
+    areas.clear();
+    lineIndex.clear();
+    lineIndexStale = true;
+    transmissionLines.clear();
+    dispatchLPStale = true;
+
+    names = make_shared<NameTable>();
 }
 
 //
 // adjustPlantsForConditions():  Adjust the available capacity of each plant by
 //                      calling each plants virtual function calculateOutput.
+//                      Only the plants with a rating input changed since they
+//                      were last rated are rated again.  The power already
+//                      allocated from a plant stays allocated, except for
+//                      what a plant no longer makes: those allocations are
+//                      released and requested again (see moveOverAllocations).
 //
 void PowerGrid::adjustPlantsForConditions() {
     // In assignment 2 and beyond, the plant vector contains pointers to a
     // plant object, not a plant object.   When we itereate, the iteration variable
     // is a pointer so need to use the -> notation instead of the . notation.
+    if (unratedPlants.empty())
+        return;
+
+    // When the plant store is used and many plants changed, each type of plant
+    // is rated in one batch and the results are copied back to the plant objects.
+    if (plantStoreEnabled && unratedPlants.size() * STORE_BATCH_FRACTION >= plants.size()) {
+        if (plantStoreStale) {
+            plantStore.build(plants);
+            plantStoreStale = false;
+        }
+        plantStore.rateAll();
+        ratedOutputTotal += plantStore.applyToPlants();
+    }
+
+    // Loop and call the calculateOutput for each plant that is not rated yet.
+    for (size_t slot : unratedPlants) {
+        if (plants[slot]->isRatingStale()) {
+            PowerPlant* pPlant = writablePlant(slot);
+            double oldOutput = pPlant->getCurrentOutput();
+            pPlant->calculateOutput();
+            ratedOutputTotal += pPlant->getCurrentOutput() - oldOutput;
+        }
+    }
+
+    // Plants rated below the power already allocated from them
+    vector<size_t> overAllocated;
+    for (size_t slot : unratedPlants) {
+        if (plants[slot]->getCapacityAllocated() > FP_ROUND(plants[slot]->getCurrentOutput()))
+            overAllocated.push_back(slot);
+    }
+    unratedPlants.clear();
+
+    if (!overAllocated.empty())
+        moveOverAllocations(overAllocated);
+}
+
+//
+// rebuildPlantIndex():  Builds the index of available plant capacity and
+//                      connects each plant to its slot so the index follows
+//                      every reduceCapacity and calculateOutput.  For merit
+//                      order the slots are sorted by operating cost (plants
+//                      with the same cost stay in file order).  The plants
+//                      a branch still shares are not connected; they never
+//                      change in the branch.
+//
+void PowerGrid::rebuildPlantIndex() {
+    plantIndexOrder = plants;
+    if (plantSelection == PLANT_MERIT_ORDER) {
+        stable_sort(plantIndexOrder.begin(), plantIndexOrder.end(), [](const PowerPlant* a, const PowerPlant* b) {
+            return a->getOperatingCost() < b->getOperatingCost();
+        });
+    }
+
+    vector<double> available;
+    available.reserve(plantIndexOrder.size());
+    plantIndexSlot.resize(plantIndexOrder.size());
+    for (size_t i = 0; i < plantIndexOrder.size(); i++) {
+        size_t plant = plantIndexOrder[i]->getGridSlot();
+        plantIndexSlot[plant] = i;
+        if (!isPlantShared(plant))
+            plantIndexOrder[i]->attachIndex(&plantIndex, i);
+        available.push_back(plantIndexOrder[i]->getAvailableCapacity());
+    }
+
+    plantIndex.build(available);
+    plantIndexStale = false;
+}
+
+//
+// setPlantSelection():  Sets how a plant is picked for each request.  The
+//                      plant index is put in the new order before the next
+//                      distribution.
+//
+void PowerGrid::setPlantSelection(PlantSelection mode) {
+    if (mode != plantSelection) {
+        plantSelection = mode;
+        plantIndexStale = true;
+    }
+}
+
+//
+// enablePlantStore():  Turns the struct-of-arrays plant store on or off.  The
+//                      store is built the next time the plants are adjusted.
+//
+void PowerGrid::enablePlantStore(bool enable) {
+    if (isBranch())
+        return;         // The store would connect to plants the branch shares
+    plantStoreEnabled = enable;
+    if (enable) {
+        plantStoreStale = true;
+    }
+    else {
+        plantStore.clear();
+    }
+}
+
+//
+// mergePlants() Adds all of the plants read into a buffer to the grid.  The
+//          grid's arena takes over the arena that holds the plants, and the
+//          names are moved into the grid's name table.
+//
+void PowerGrid::mergePlants(vector<PowerPlant*>& plantBuffer, PlantArena& bufferArena, const NameTable& bufferNames) {
+    plantArena.adopt(bufferArena);
 
-    // Loop and call the calculateOutput for each plant.
-    for (const auto& plant : plants) {
-        plant->calculateOutput();
+    plants.reserve(plants.size() + plantBuffer.size());
+    for (auto pPlant : plantBuffer) {
+        pPlant->moveNames(bufferNames, *names);
+        addPlantToGrid(pPlant);
     }
+    plantBuffer.clear();
 }
 
 //********************************************************
@@ -59,13 +233,53 @@ void PowerGrid::adjustPlantsForConditions() {
 //
 // addServiceArea()
 //
-void PowerGrid::addServiceArea(const string name, const double requestedCap, const double costPerMW) {
+void PowerGrid::addServiceArea(string_view name, const double requestedCap, const double costPerMW) {
  
-    // Declare a new local object and have constructor set the values.
-    ServiceArea newSvcArea (name, requestedCap, costPerMW);
-    
-    // Insert into vector
-    areas.push_back(newSvcArea);
+    // Construct the new area in place at the end of the vector
+    areas.emplace_back(names->intern(name), requestedCap, costPerMW);
+
+    // The vector may have moved the areas, so the queue must be rebuilt
+    areaQueueStale = true;
+    dispatchLPStale = true;
+}
+
+//
+// mergeServiceAreas() Adds all of the areas read into a buffer to the grid.
+//          The names are moved into the grid's name table.
+//
+void PowerGrid::mergeServiceAreas(vector<ServiceArea>& areaBuffer, const NameTable& bufferNames) {
+    for (auto& area : areaBuffer)
+        area.moveNames(bufferNames, *names);
+    areas.insert(areas.end(), make_move_iterator(areaBuffer.begin()), make_move_iterator(areaBuffer.end()));
+    areaBuffer.clear();
+    areaQueueStale = true;
+    dispatchLPStale = true;
+}
+
+//
+// rebuildAreaQueue() Builds the priority queue of the areas that need power
+//          and connects each area to its entry so the queue follows every
+//          addCapacity
+//
+void PowerGrid::rebuildAreaQueue() {
+    vector<double> prices, deficits;
+    prices.reserve(areas.size());
+    deficits.reserve(areas.size());
+    for (size_t i = 0; i < areas.size(); i++) {
+        areas[i].attachQueue(&areaQueue, i);
+        prices.push_back(areas[i].getMWPrice());
+        deficits.push_back(areas[i].getPowerDeficit());
+    }
+
+    areaQueue.build(prices, deficits, FP_ROUND(0));
+    areaQueueStale = false;
+}
+
+//
+// setAreaSchedule() Sets the order the areas are served in
+//
+void PowerGrid::setAreaSchedule(AreaSchedule mode) {
+    areaSchedule = mode;
 }
 
 //********************************************************
@@ -75,11 +289,51 @@ void PowerGrid::addServiceArea(const string name, const double requestedCap, con
 //
 // addTransLine()
 //
-void PowerGrid::addTransmissionLine(int lineID, string lineName, double capacity, double efficiency) {
+void PowerGrid::addTransmissionLine(int lineID, string_view lineName, double capacity, double efficiency) {
     
-    // Declare Transmissionline object and have constructor set the values.
-    TransmissionLine newTransmissionLine(lineID, lineName, capacity, efficiency);
+    // Construct the new line in place at the end of the vector
+    transmissionLines.emplace_back(lineID, names->intern(lineName), capacity, efficiency);
+
+    // The vector may have moved the lines, so the index must be rebuilt
+    lineIndexStale = true;
+    dispatchLPStale = true;
+}
+
+//
+// mergeTransmissionLines() Adds all of the lines read into a buffer to the grid.
+//          The names are moved into the grid's name table.
+//
+void PowerGrid::mergeTransmissionLines(vector<TransmissionLine>& lineBuffer, const NameTable& bufferNames) {
+    for (auto& line : lineBuffer)
+        line.moveNames(bufferNames, *names);
+    transmissionLines.insert(transmissionLines.end(), make_move_iterator(lineBuffer.begin()), make_move_iterator(lineBuffer.end()));
+    lineBuffer.clear();
+    lineIndexStale = true;
+    dispatchLPStale = true;
+}
 
-    // Insert into vector
-    transmissionLines.push_back(newTransmissionLine);
-}
\ No newline at end of file
+//
+// rebuildLineIndex() Builds the index of remaining line capacity and connects
+//          each line to its slot so the index follows every reduceCapacity
+//
+void PowerGrid::rebuildLineIndex() {
+    vector<double> remaining;
+    remaining.reserve(transmissionLines.size());
+    for (size_t i = 0; i < transmissionLines.size(); i++) {
+        transmissionLines[i].attachIndex(&lineIndex, i);
+        remaining.push_back(transmissionLines[i].getRemainingCapacity());
+    }
+
+    lineIndex.enableBestFit(lineSelection == LINE_BEST_FIT);
+    lineIndex.build(remaining);
+    lineIndexStale = false;
+}
+
+//
+// setLineSelection() Sets how a line is picked for each request
+//
+void PowerGrid::setLineSelection(LineSelection mode) {
+    lineSelection = mode;
+    if (!lineIndexStale)
+        lineIndex.enableBestFit(mode == LINE_BEST_FIT);
+}
@@ -0,0 +1,343 @@
+// File: Redispatch.cpp
+//
+// Contains the functions of the PowerGrid class for re-dispatching only the
+// plants whose conditions changed (e.g. setSunlightHours, setAvgWindSpeed,
+// setThrottle) instead of rating every plant and running the distribution
+// again.
+//
+// Each setter marks its plant dirty.  For each dirty plant:
+//  1) Every allocation the plant made (found in the allocation ledger) is
+//     released: the plant, the line, and the area get the power back.
+//  2) The plant is rated for its new conditions.
+//  3) The areas it served request the same power again (no more than they
+//     still need), in the order the requests were first made.  The usual
+//     plant and line selection picks where the power comes from, which may
+//     be the same plant.
+//
+// A derated line (redispatchLine) releases its newest allocations until the
+// power on it is within its new limit, and those requests are made again
+// the same way.  An area whose demand changed (redispatchArea) gives back
+// its newest allocations while it has more power than it needs, or
+// requests what it is short.  serveAreas has only the listed areas request
+// what they are short (e.g. the areas an outage left short, once the plant
+// is back).  A plant that adjustPlantsForConditions rates below the power
+// allocated from it releases its newest allocations the same way
+// (moveOverAllocations).
+//
+// Only the changed plants, lines, and areas, their allocations, and the
+// areas they served are touched, so the work does not grow with the size
+// of the grid.
+//
+#include <algorithm>
+#include "../header/PowerGrid.h"
+
+using namespace std;
+
+// The ledger is compacted when at least this many allocations are dead and
+// they are more than half of the ledger
+const size_t MIN_DEAD_TO_COMPACT = 1024;
+
+
+//
+// clearAllocationLedger():  Forgets every allocation and dirty plant
+//
+void PowerGrid::clearAllocationLedger() {
+    allocations.clear();
+    fill(plantAllocations.begin(), plantAllocations.end(), NO_ALLOCATION);
+    fill(lineAllocations.begin(), lineAllocations.end(), NO_ALLOCATION);
+    fill(areaAllocations.begin(), areaAllocations.end(), NO_ALLOCATION);
+    deadAllocations = 0;
+
+    for (size_t slot : dirtyPlants) {
+        if (!isPlantShared(slot))
+            plants[slot]->clearDirty();
+    }
+    dirtyPlants.clear();
+}
+
+
+//
+// releaseAllocation():  Gives the power of a live allocation back to its
+//                  plant, line, and area, and marks it dead
+//
+void PowerGrid::releaseAllocation(size_t i) {
+    Allocation& alloc = allocations[i];
+    writablePlant(alloc.plant)->releaseCapacity(alloc.drawn);
+    transmissionLines[alloc.line].releaseCapacity(alloc.delivered);
+    areas[alloc.area].removeCapacity(alloc.delivered);
+
+    alloc.live = false;
+    deadAllocations++;
+}
+
+
+//
+// requestAgain():  Has the areas of released allocations request the same
+//                  power again (no more than they still need), in the order
+//                  the requests were first made
+//
+void PowerGrid::requestAgain(vector<size_t>& released) {
+    sort(released.begin(), released.end());
+
+    plantsHaveCapacity = 1;
+    linesHaveCapacity = 1;
+    for (size_t i : released) {
+        // Copy the entry, the ledger grows as the power is allocated
+        Allocation alloc = allocations[i];
+        ServiceArea& area = areas[alloc.area];
+        if (area.getPowerDeficit() > FP_ROUND(0))
+            allocatePowerToArea(area, min(alloc.requested, area.getPowerDeficit()));
+    }
+}
+
+
+//
+// compactAllocationLedger():  Removes the dead allocations from the ledger
+//                  once they are most of it, so the ledger does not grow
+//                  with the number of changes.  The live allocations keep
+//                  their order.
+//
+void PowerGrid::compactAllocationLedger() {
+    if (deadAllocations < MIN_DEAD_TO_COMPACT || deadAllocations * 2 <= allocations.size())
+        return;
+
+    fill(plantAllocations.begin(), plantAllocations.end(), NO_ALLOCATION);
+    fill(lineAllocations.begin(), lineAllocations.end(), NO_ALLOCATION);
+    fill(areaAllocations.begin(), areaAllocations.end(), NO_ALLOCATION);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < allocations.size(); i++) {
+        if (!allocations[i].live)
+            continue;
+
+        Allocation& alloc = allocations[kept] = allocations[i];
+        alloc.nextForPlant = plantAllocations[alloc.plant];
+        alloc.nextForLine = lineAllocations[alloc.line];
+        alloc.nextForArea = areaAllocations[alloc.area];
+        plantAllocations[alloc.plant] = kept;
+        lineAllocations[alloc.line] = kept;
+        areaAllocations[alloc.area] = kept;
+        kept++;
+    }
+    allocations.resize(kept);
+    deadAllocations = 0;
+}
+
+
+//
+// getDispatchedAssets():  Marks the plants and lines the live allocations in
+//                  the ledger were made from (1) and the ones never picked
+//                  (0).  A plant that was picked counts even if nothing
+//                  could be drawn from it.
+//
+void PowerGrid::getDispatchedAssets(vector<uint8_t>& plantUsed, vector<uint8_t>& lineUsed) const {
+    plantUsed.assign(plants.size(), 0);
+    lineUsed.assign(transmissionLines.size(), 0);
+    for (const auto& alloc : allocations) {
+        if (alloc.live) {
+            plantUsed[alloc.plant] = 1;
+            lineUsed[alloc.line] = 1;
+        }
+    }
+}
+
+
+//
+// getLedgerTotals():  Adds up the live allocations in the ledger: the power
+//                  drawn from each plant, and the power delivered to the
+//                  areas (returned).  Used to check the ledger against the
+//                  plants, lines, and areas.
+//
+double PowerGrid::getLedgerTotals(vector<double>& plantDrawn) const {
+    plantDrawn.assign(plants.size(), 0.0);
+    double delivered = 0.0;
+    for (const auto& alloc : allocations) {
+        if (alloc.live) {
+            plantDrawn[alloc.plant] += alloc.drawn;
+            delivered += alloc.delivered;
+        }
+    }
+    return delivered;
+}
+
+
+//
+// moveOverAllocations():  Releases the newest allocations of each listed plant
+//                  while more power is allocated from it than it now makes,
+//                  and requests that power again (from other plants, or
+//                  whatever this plant still has).  Only allocations in the
+//                  ledger can be moved.
+//
+void PowerGrid::moveOverAllocations(const vector<size_t>& slots) {
+    vector<size_t> released;
+    for (size_t slot : slots) {
+        const PowerPlant* pPlant = plants[slot];
+        for (size_t i = plantAllocations[slot];
+             i != NO_ALLOCATION && pPlant->getCapacityAllocated() > FP_ROUND(pPlant->getCurrentOutput());
+             i = allocations[i].nextForPlant) {
+            if (allocations[i].live) {
+                releaseAllocation(i);
+                released.push_back(i);
+                pPlant = plants[slot];      // releaseAllocation may have copied a shared plant
+            }
+        }
+    }
+
+    if (verbose)
+        cout << endl << "Output lowered below the power allocated, "
+            << released.size() << " allocation(s) released." << endl;
+
+    requestAgain(released);
+    compactAllocationLedger();
+}
+
+
+//
+// redispatchDirtyPlants():  Re-rates the plants whose inputs changed and moves
+//                  their allocations.  The areas of the moved allocations
+//                  are added to pMovedAreas (if given).  Returns the number
+//                  of plants re-rated.
+//
+int PowerGrid::redispatchDirtyPlants(vector<size_t>* pMovedAreas) {
+    if (dirtyPlants.empty())
+        return 0;
+
+    // Take the list first, rating a plant does not mark it dirty again
+    vector<size_t> dirty;
+    dirty.swap(dirtyPlants);
+
+    // Release the allocations of each dirty plant and rate it
+    vector<size_t> released;        // Ledger entries to request again
+    for (size_t slot : dirty) {
+        PowerPlant* pPlant = writablePlant(slot);
+        pPlant->clearDirty();
+
+        for (size_t i = plantAllocations[slot]; i != NO_ALLOCATION; i = allocations[i].nextForPlant) {
+            if (allocations[i].live) {
+                releaseAllocation(i);
+                released.push_back(i);
+            }
+        }
+        plantAllocations[slot] = NO_ALLOCATION;
+
+        double oldOutput = pPlant->getCurrentOutput();
+        pPlant->calculateOutput();
+        ratedOutputTotal += pPlant->getCurrentOutput() - oldOutput;
+    }
+
+    // The dirty plants were rated, so they no longer wait in the unrated list
+    unratedPlants.erase(remove_if(unratedPlants.begin(), unratedPlants.end(),
+                                  [this](size_t slot) { return !plants[slot]->isRatingStale(); }),
+                        unratedPlants.end());
+
+    if (verbose)
+        cout << endl << "Re-dispatching " << dirty.size() << " plant(s), "
+            << released.size() << " allocation(s) released." << endl;
+
+    requestAgain(released);
+    if (pMovedAreas != nullptr) {
+        for (size_t i : released)
+            pMovedAreas->push_back(allocations[i].area);
+    }
+    compactAllocationLedger();
+    return (int)dirty.size();
+}
+
+
+//
+// redispatchLine():  Releases the newest allocations on a line until the
+//                  power on it is within its limit (see derateLine), and
+//                  requests that power again.  The areas of the moved
+//                  allocations are added to pMovedAreas (if given).
+//                  Returns the number of allocations moved.
+//
+int PowerGrid::redispatchLine(size_t i, vector<size_t>* pMovedAreas) {
+    const TransmissionLine& line = transmissionLines[i];
+    double limit = line.getMaxCapacity() * line.getUsableFraction();
+
+    vector<size_t> released;
+    size_t next = i < lineAllocations.size() ? lineAllocations[i] : NO_ALLOCATION;
+    for ( ; next != NO_ALLOCATION && line.getCapacityInUse() > FP_ROUND(limit); next = allocations[next].nextForLine) {
+        if (allocations[next].live) {
+            releaseAllocation(next);
+            released.push_back(next);
+        }
+    }
+
+    if (verbose)
+        cout << endl << "Re-dispatching line " << line.getLineName(*names) << ", "
+            << released.size() << " allocation(s) released." << endl;
+
+    requestAgain(released);
+    if (pMovedAreas != nullptr) {
+        for (size_t next : released)
+            pMovedAreas->push_back(allocations[next].area);
+    }
+    compactAllocationLedger();
+    return (int)released.size();
+}
+
+
+//
+// redispatchArea():  Releases the newest allocations of an area while it has
+//                  more power than it requires (see setAreaDemand), then
+//                  requests whatever it is still short.  Returns the number
+//                  of allocations released.
+//
+int PowerGrid::redispatchArea(size_t i) {
+    ServiceArea& area = areas[i];
+
+    int releasedCount = 0;
+    size_t next = i < areaAllocations.size() ? areaAllocations[i] : NO_ALLOCATION;
+    for ( ; next != NO_ALLOCATION && area.getPowerProvided() > FP_ROUND(area.getPowerRequired());
+          next = allocations[next].nextForArea) {
+        if (allocations[next].live) {
+            releaseAllocation(next);
+            releasedCount++;
+        }
+    }
+
+    // A released allocation can leave the area short
+    plantsHaveCapacity = 1;
+    linesHaveCapacity = 1;
+    requestShortfall(area);
+
+    compactAllocationLedger();
+    return releasedCount;
+}
+
+
+//
+// requestShortfall():  Requests the power an area is short in one request,
+//                  as distributePower would (split across plants and lines
+//                  only if split allocations are on).  Returns false if the
+//                  area is not short.
+//
+bool PowerGrid::requestShortfall(ServiceArea& area) {
+    double shortfall = area.getPowerRequired() - area.getPowerProvided();
+    if (shortfall <= FP_ROUND(0))
+        return false;
+
+    allocatePowerToArea(area, shortfall);
+    return true;
+}
+
+
+//
+// serveAreas():    Has each listed area that is short of power request what
+//                  it is short (e.g. the areas an outage left short, after
+//                  the plant comes back online).  No other area is touched.
+//                  Returns the number of areas that made a request.
+//
+int PowerGrid::serveAreas(const vector<size_t>& areaIndexes) {
+    plantsHaveCapacity = 1;
+    linesHaveCapacity = 1;
+
+    int requests = 0;
+    for (size_t i : areaIndexes) {
+        if (requestShortfall(areas[i]))
+            requests++;
+    }
+    compactAllocationLedger();
+    return requests;
+}
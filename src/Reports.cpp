@@ -31,7 +31,7 @@ void PowerGrid::printServceAreas() const {
 
     // Loop and print all information for each area.
     for (const auto& area : areas) {
-        string areaName =  area.getAreaName();
+        string_view areaName =  area.getAreaName(*names);
         double powerRequired = area.getPowerRequired();
         double powerProvided = area.getPowerProvided();
         double totalPriceForPower = area.getTotalPriceForPower();
@@ -79,8 +79,8 @@ void PowerGrid::printPlants() const {
 
     // Loop and print all information for each Plant.
     for (const auto& plant : plants) {
-        string plantName = plant->getName();
-        string plantType = plant->getType();
+        string_view plantName = plant->getName(*names);
+        string_view plantType = plant->getType();
         double maxCapacity = plant->getMaxPowerOutput();
         double currentOutput = plant->getCurrentOutput();
         double availableCapacity = plant->getAvailableCapacity();
@@ -91,7 +91,7 @@ void PowerGrid::printPlants() const {
             << fixed << setprecision(2) << setw(9) << right << maxCapacity << "   "
             << setw(9) << right << currentOutput << "   "
             << setw(10) << right << availableCapacity << "   "
-            << left << plant->getCurrentCondition() << endl;
+            << left << plant->getCurrentCondition(*names) << endl;
 
         // Total sum
         maxTotal += maxCapacity;
@@ -128,7 +128,7 @@ void PowerGrid::printTransmissionLines() const {
     // Loop and print all information for each transmission line.
     for (const auto& line : transmissionLines) {
         int lineID = line.getLineID();
-        string lineName = line.getLineName();
+        string_view lineName = line.getLineName(*names);
         double efficiency = line.getEfficiency();
         double capacity = line.getMaxCapacity();
         double remainingCapacity = line.getRemainingCapacity();
@@ -173,7 +173,7 @@ void PowerGrid::generateUsageReport() {
         double powerPrice = area.getTotalPriceForPower();
 
         // Print out the demand inforamtion
-        cout << setw(10) << left << area.getAreaName() << " | "
+        cout << setw(10) << left << area.getAreaName(*names) << " | "
             << fixed << setprecision(2) << setw(12) << right << powerRequired << " | "
             << fixed << setprecision(2) << setw(12) << right << powerProvided << " | "
             << fixed << setprecision(2) << setw(5) << right << percentProvided << "%  | "
@@ -204,25 +204,62 @@ void PowerGrid::generateUsageReport() {
     // Determine the profit or loss for operating the grid
     //
 
-    double grossPay = 0.0;
-    double totalCost = 0.0;
-    double profit = 0.0;
-
-    // Loop through each area to total up the gross payment
-    for (const auto& area : areas) {
-        grossPay += area.getTotalPriceForPower();
-    }
-
-    // Loop through each plant to total up the operating cost
-    for (const auto& plant : plants) {
-        totalCost += plant->getCostOfAllocatedPower();
-    }
+    double grossPay = getTotalRevenue();        // Total payment of all areas
+    double totalCost = getTotalOperatingCost(); // Total operating cost of all plants
 
     // Determine profit
-    profit = grossPay - totalCost;
+    double profit = grossPay - totalCost;
 
     cout << "Total price by all areas paid for power they used today: $" << grossPay << endl;
     cout << "Total cost of producing this power: $" << totalCost << endl;
     cout << "Operating profit for my Power Grid today: $" << profit << endl;
 
-}
\ No newline at end of file
+}
+
+
+//***********************************************
+//
+//      Totals of the current distribution
+//
+//***********************************************
+
+//
+// getTotalPowerRequired() - Returns the MW required by all areas
+//
+double PowerGrid::getTotalPowerRequired() const {
+    double total = 0.0;
+    for (const auto& area : areas)
+        total += area.getPowerRequired();
+    return total;
+}
+
+//
+// getTotalPowerSupplied() - Returns the MW delivered to all areas
+//
+double PowerGrid::getTotalPowerSupplied() const {
+    double total = 0.0;
+    for (const auto& area : areas)
+        total += area.getPowerProvided();
+    return total;
+}
+
+//
+// getTotalRevenue() - Returns the total paid by all areas for their power
+//
+double PowerGrid::getTotalRevenue() const {
+    double total = 0.0;
+    for (const auto& area : areas)
+        total += area.getTotalPriceForPower();
+    return total;
+}
+
+//
+// getTotalOperatingCost() - Returns the operating cost of the power allocated
+//                  from all plants
+//
+double PowerGrid::getTotalOperatingCost() const {
+    double total = 0.0;
+    for (const auto& plant : plants)
+        total += plant->getCostOfAllocatedPower();
+    return total;
+}
@@ -0,0 +1,164 @@
+// File: ScenarioEngine.cpp
+//
+// Contains the function definitions for the Monte Carlo weather scenario
+// engine (see ScenarioEngine.h)
+//
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <memory>
+#include "../header/ScenarioEngine.h"
+
+using namespace std;
+
+//
+// drawFactor() - Draws one weather factor from its distribution
+//
+template <typename Random>
+static double drawFactor(const WeatherDistribution& distribution, Random& random) {
+    switch (distribution.type) {
+    case DIST_UNIFORM:
+        return uniform_real_distribution<double>(distribution.value1, distribution.value2)(random);
+    case DIST_NORMAL:
+        return max(0.0, normal_distribution<double>(distribution.value1, distribution.value2)(random));
+    case DIST_FIXED:
+        break;
+    }
+    return distribution.value1;
+}
+
+
+//
+// drawWeather() - Draws the factors for all of the weather inputs
+//
+template <typename Random>
+ScenarioEngine::WeatherFactors ScenarioEngine::drawWeather(const ScenarioConfig& config, Random& random) {
+    WeatherFactors factors;
+    factors.sunlight = drawFactor(config.sunlight, random);
+    factors.windSpeed = drawFactor(config.windSpeed, random);
+    factors.inflow = drawFactor(config.inflow, random);
+    factors.throttle = drawFactor(config.throttle, random);
+    return factors;
+}
+
+
+//
+// applyWeather() - Sets the weather inputs of the plants of a grid restored
+//          to the data file values.  Plants that do not depend on the
+//          weather are not changed (so a branch does not copy them).
+//
+void ScenarioEngine::applyWeather(PowerGrid& scenarioGrid, const ScenarioConfig& config, size_t scenario) {
+    // The random numbers depend only on the seed and the scenario
+    seed_seq seeds{ (unsigned)(config.seed >> 32), (unsigned)config.seed, (unsigned)(scenario >> 32), (unsigned)scenario };
+    mt19937_64 random(seeds);
+
+    WeatherFactors factors = drawWeather(config, random);
+    const vector<PowerPlant*>& plants = scenarioGrid.getPlants();
+
+    for (size_t i = 0; i < plants.size(); i++) {
+        PlantType type = plants[i]->getPlantType();
+        if (type == PlantType::Nuclear || type == PlantType::Geothermal)
+            continue;
+
+        if (!config.sharedWeather)
+            factors = drawWeather(config, random);
+
+        PowerPlant* pPlant = scenarioGrid.writablePlant(i);
+        switch (type) {
+        case PlantType::Solar: {
+            SolarFarm* pSolar = static_cast<SolarFarm*>(pPlant);
+            pSolar->setSunlightHours(pSolar->getSunlightHours() * factors.sunlight);
+            break;
+        }
+        case PlantType::Wind: {
+            WindFarm* pWind = static_cast<WindFarm*>(pPlant);
+            pWind->setAvgWindSpeed(pWind->getAvgWindSpeed() * factors.windSpeed);
+            break;
+        }
+        case PlantType::Hydro: {
+            HydroPlant* pHydro = static_cast<HydroPlant*>(pPlant);
+            pHydro->setFlowRate(pHydro->getFlowRate() * factors.inflow);
+            break;
+        }
+        case PlantType::Gas: {
+            GasPlant* pGas = static_cast<GasPlant*>(pPlant);
+            pGas->setThrottle(min(100.0, pGas->getThrottle() * factors.throttle));
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+
+//
+// run() - Runs all of the scenarios on the pool's workers.  Each worker makes
+//         a branch of the grid the first time it runs a scenario.
+//
+ScenarioResults ScenarioEngine::run(const ScenarioConfig& config) {
+    ScenarioResults results;
+    results.unmetDemand.assign(config.scenarios, 0.0);
+    results.profit.assign(config.scenarios, 0.0);
+
+    vector<unique_ptr<PowerGrid>> branches(pool.size());
+    auto start = chrono::steady_clock::now();
+
+    pool.parallelFor(config.scenarios, 0, [&](size_t scenario, size_t worker) {
+        unique_ptr<PowerGrid>& pBranch = branches[worker];
+        if (!pBranch) {
+            pBranch = grid.branch();
+            pBranch->setVerbose(false);
+            pBranch->saveBaseline();
+        }
+        PowerGrid& scenarioGrid = *pBranch;
+        scenarioGrid.restoreBaseline();
+
+        applyWeather(scenarioGrid, config, scenario);
+        scenarioGrid.adjustPlantsForConditions();
+
+        scenarioGrid.distributePower(60);
+        for (int pass = 0; pass < 4; pass++)
+            scenarioGrid.distributePower(10);
+
+        results.unmetDemand[scenario] = scenarioGrid.getTotalPowerRequired() - scenarioGrid.getTotalPowerSupplied();
+        results.profit[scenario] = scenarioGrid.getTotalRevenue() - scenarioGrid.getTotalOperatingCost();
+    });
+
+    auto stop = chrono::steady_clock::now();
+    results.seconds = chrono::duration<double>(stop - start).count();
+    return results;
+}
+
+
+//
+// summarize() - Returns the mean and percentiles of the values.  A
+//          percentile between two values is interpolated.
+//
+ScenarioStats ScenarioResults::summarize(const vector<double>& values) {
+    ScenarioStats stats;
+    if (values.empty())
+        return stats;
+
+    vector<double> sorted = values;
+    sort(sorted.begin(), sorted.end());
+
+    // Lambda function to find one percentile
+    auto percentile = [&sorted](double percent) {
+        double position = percent / 100.0 * (sorted.size() - 1);
+        size_t below = (size_t)position;
+        size_t above = min(below + 1, sorted.size() - 1);
+        return sorted[below] + (sorted[above] - sorted[below]) * (position - below);
+    };
+
+    stats.mean = accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+    stats.minimum = sorted.front();
+    stats.p5 = percentile(5);
+    stats.p25 = percentile(25);
+    stats.p50 = percentile(50);
+    stats.p75 = percentile(75);
+    stats.p95 = percentile(95);
+    stats.maximum = sorted.back();
+    return stats;
+}
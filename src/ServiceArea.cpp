@@ -4,6 +4,7 @@
 //
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include "../header/ServiceArea.h"
 
 //
@@ -12,4 +13,14 @@
 //
 void ServiceArea::addCapacity(double amount) {
     powerReceived += amount;
-}
\ No newline at end of file
+    deficitChanged();
+}
+
+//
+// removeCapacity() -- Removes capacity from the service area -
+// The power committed to this location was released
+//
+void ServiceArea::removeCapacity(double amount) {
+    powerReceived = max(0.0, powerReceived - amount);
+    deficitChanged();
+}
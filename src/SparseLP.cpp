@@ -0,0 +1,507 @@
+// File: SparseLP.cpp
+//
+// Contains the function definitions for the SparseLP class (see SparseLP.h)
+//
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+#include "../header/SparseLP.h"
+
+using namespace std;
+
+//********************************************************
+//*****             Building the model               *****
+//********************************************************
+
+int SparseLP::addRow(LPRowType type, double value) {
+    rowType.push_back(type);
+    rhs.push_back(value);
+    haveBasis = false;
+    return rowCount() - 1;
+}
+
+int SparseLP::addVariable(double lo, double up, double varCost) {
+    columns.emplace_back();
+    lower.push_back(lo);
+    upper.push_back(up);
+    cost.push_back(varCost);
+    haveBasis = false;
+    return structCount() - 1;
+}
+
+void SparseLP::addCoefficient(int row, int var, double value) {
+    assert(row >= 0 && row < rowCount() && var >= 0 && var < structCount());
+    if (value != 0.0)
+        columns[var].push_back({ row, value });
+}
+
+void SparseLP::clear() {
+    columns.clear();
+    cost.clear();
+    lower.clear();
+    upper.clear();
+    rhs.clear();
+    rowType.clear();
+    basic.clear();
+    status.clear();
+    x.clear();
+    basisInverse.clear();
+    haveBasis = false;
+}
+
+
+//********************************************************
+//*****              Basis operations                *****
+//********************************************************
+
+//
+// factorBasis() - Builds the inverse of the basis matrix from scratch with
+//          Gauss-Jordan elimination.  Returns false if the basis is singular.
+//
+bool SparseLP::factorBasis() {
+    int m = rowCount();
+    vector<double> matrix(size_t(m) * m, 0.0);
+    basisInverse.assign(size_t(m) * m, 0.0);
+
+    for (int k = 0; k < m; k++) {
+        int j = basic[k];
+        if (j < structCount()) {
+            for (const auto& e : columns[j])
+                matrix[size_t(e.row) * m + k] = e.value;
+        }
+        else {
+            matrix[size_t(j - structCount()) * m + k] = 1.0;
+        }
+        basisInverse[size_t(k) * m + k] = 1.0;
+    }
+
+    for (int col = 0; col < m; col++) {
+        // Partial pivoting
+        int pivotRow = col;
+        for (int r = col + 1; r < m; r++) {
+            if (fabs(matrix[size_t(r) * m + col]) > fabs(matrix[size_t(pivotRow) * m + col]))
+                pivotRow = r;
+        }
+        if (fabs(matrix[size_t(pivotRow) * m + col]) < 1e-12)
+            return false;
+
+        if (pivotRow != col) {
+            for (int c = 0; c < m; c++) {
+                swap(matrix[size_t(col) * m + c], matrix[size_t(pivotRow) * m + c]);
+                swap(basisInverse[size_t(col) * m + c], basisInverse[size_t(pivotRow) * m + c]);
+            }
+        }
+
+        double scale = 1.0 / matrix[size_t(col) * m + col];
+        for (int c = 0; c < m; c++) {
+            matrix[size_t(col) * m + c] *= scale;
+            basisInverse[size_t(col) * m + c] *= scale;
+        }
+
+        for (int r = 0; r < m; r++) {
+            double factor = matrix[size_t(r) * m + col];
+            if (r == col || factor == 0.0)
+                continue;
+            for (int c = 0; c < m; c++) {
+                matrix[size_t(r) * m + c] -= factor * matrix[size_t(col) * m + c];
+                basisInverse[size_t(r) * m + c] -= factor * basisInverse[size_t(col) * m + c];
+            }
+        }
+    }
+    return true;
+}
+
+//
+// computeBasicValues() - x_B = B^-1 (b - A_N x_N)
+//
+void SparseLP::computeBasicValues() {
+    int m = rowCount();
+    vector<double> residual(rhs);
+
+    for (int j = 0; j < columnCount(); j++) {
+        if (status[j] == BASIC || x[j] == 0.0)
+            continue;
+        if (j < structCount()) {
+            for (const auto& e : columns[j])
+                residual[e.row] -= e.value * x[j];
+        }
+        else {
+            residual[j - structCount()] -= x[j];
+        }
+    }
+
+    for (int k = 0; k < m; k++) {
+        double value = 0.0;
+        for (int i = 0; i < m; i++)
+            value += basisInverse[size_t(k) * m + i] * residual[i];
+        x[basic[k]] = value;
+    }
+}
+
+//
+// computeDuals() - y' = c_B' B^-1
+//
+void SparseLP::computeDuals(vector<double>& y) const {
+    int m = rowCount();
+    y.assign(m, 0.0);
+    for (int k = 0; k < m; k++) {
+        double c = columnCost(basic[k]);
+        if (c == 0.0)
+            continue;
+        for (int i = 0; i < m; i++)
+            y[i] += c * basisInverse[size_t(k) * m + i];
+    }
+}
+
+//
+// reducedCost() - d_j = c_j - y' A_j
+//
+double SparseLP::reducedCost(int j, const vector<double>& y) const {
+    if (j >= structCount())
+        return -y[j - structCount()];
+
+    double d = cost[j];
+    for (const auto& e : columns[j])
+        d -= y[e.row] * e.value;
+    return d;
+}
+
+//
+// solveColumn() - w = B^-1 A_j
+//
+void SparseLP::solveColumn(int j, vector<double>& w) const {
+    int m = rowCount();
+    w.assign(m, 0.0);
+    if (j >= structCount()) {
+        int row = j - structCount();
+        for (int k = 0; k < m; k++)
+            w[k] = basisInverse[size_t(k) * m + row];
+        return;
+    }
+    for (const auto& e : columns[j]) {
+        for (int k = 0; k < m; k++)
+            w[k] += basisInverse[size_t(k) * m + e.row] * e.value;
+    }
+}
+
+//
+// pivot() - Column 'entering' replaces the basic column of a row.  w is
+//           B^-1 times the entering column.
+//
+void SparseLP::pivot(int row, int entering, const vector<double>& w) {
+    int m = rowCount();
+    double* pivotRow = &basisInverse[size_t(row) * m];
+    double scale = 1.0 / w[row];
+    for (int c = 0; c < m; c++)
+        pivotRow[c] *= scale;
+
+    for (int k = 0; k < m; k++) {
+        if (k == row || w[k] == 0.0)
+            continue;
+        double* target = &basisInverse[size_t(k) * m];
+        for (int c = 0; c < m; c++)
+            target[c] -= w[k] * pivotRow[c];
+    }
+
+    basic[row] = entering;
+    status[entering] = BASIC;
+}
+
+bool SparseLP::isPrimalFeasible() const {
+    for (int k = 0; k < rowCount(); k++) {
+        int j = basic[k];
+        if (x[j] < columnLower(j) - 1e-7 || x[j] > columnUpper(j) + 1e-7)
+            return false;
+    }
+    return true;
+}
+
+bool SparseLP::isDualFeasible() const {
+    vector<double> y;
+    computeDuals(y);
+    for (int j = 0; j < columnCount(); j++) {
+        if (status[j] == BASIC || columnLower(j) == columnUpper(j))
+            continue;
+        double d = reducedCost(j, y);
+        if ((status[j] == AT_LOWER && d < -1e-7) || (status[j] == AT_UPPER && d > 1e-7))
+            return false;
+    }
+    return true;
+}
+
+//
+// coldStart() - The slack basis with every structural at its lower bound
+//
+void SparseLP::coldStart() {
+    int m = rowCount();
+    basic.resize(m);
+    status.assign(columnCount(), AT_LOWER);
+    x.assign(columnCount(), 0.0);
+
+    for (int j = 0; j < structCount(); j++)
+        x[j] = lower[j];
+    for (int k = 0; k < m; k++) {
+        basic[k] = structCount() + k;
+        status[basic[k]] = BASIC;
+    }
+
+    // The inverse of the slack basis is the identity
+    basisInverse.assign(size_t(m) * m, 0.0);
+    for (int k = 0; k < m; k++)
+        basisInverse[size_t(k) * m + k] = 1.0;
+    computeBasicValues();
+}
+
+
+//********************************************************
+//*****              Simplex methods                 *****
+//********************************************************
+
+//
+// primalSimplex() - Starts from a feasible basis and moves to an optimal one.
+//          Dantzig pricing (most negative reduced cost); Bland's rule is used
+//          after a run of degenerate pivots so the method can not cycle.
+//
+LPStatus SparseLP::primalSimplex(int iterationLimit) {
+    vector<double> y, w;
+    int degenerateRun = 0;
+    int sinceFactor = 0;
+
+    while (iterations < iterationLimit) {
+        bool useBland = degenerateRun > 50;
+        computeDuals(y);
+
+        // Pick the entering column
+        int    entering = -1;
+        double best = 0.0;
+        for (int j = 0; j < columnCount(); j++) {
+            if (status[j] == BASIC || columnLower(j) == columnUpper(j))
+                continue;
+            double d = reducedCost(j, y);
+            double gain = (status[j] == AT_LOWER) ? -d : d;
+            if (gain > TOLERANCE && (entering < 0 || (!useBland && gain > best))) {
+                entering = j;
+                best = gain;
+                if (useBland)
+                    break;
+            }
+        }
+        if (entering < 0)
+            return LP_OPTIMAL;
+
+        double direction = (status[entering] == AT_LOWER) ? 1.0 : -1.0;
+        solveColumn(entering, w);
+
+        // Ratio test: the entering column may reach its own other bound first
+        double step = columnUpper(entering) - columnLower(entering);
+        int    leaving = -1;
+        bool   leavesAtLower = true;
+        for (int k = 0; k < rowCount(); k++) {
+            double change = -direction * w[k];      // Change of the basic value per unit step
+            if (fabs(change) <= TOLERANCE)
+                continue;
+            int j = basic[k];
+            double limit;
+            if (change < 0)
+                limit = (x[j] - columnLower(j)) / -change;
+            else if (columnUpper(j) != INF)
+                limit = (columnUpper(j) - x[j]) / change;
+            else
+                continue;
+            limit = max(limit, 0.0);
+
+            if (limit < step - TOLERANCE
+                || (leaving >= 0 && limit <= step + TOLERANCE && fabs(w[k]) > fabs(w[leaving]))) {
+                step = limit;
+                leaving = k;
+                leavesAtLower = change < 0;
+            }
+        }
+        if (step == INF)
+            return LP_UNBOUNDED;
+
+        // Move along the edge
+        x[entering] += direction * step;
+        for (int k = 0; k < rowCount(); k++)
+            x[basic[k]] -= direction * step * w[k];
+        degenerateRun = (step <= TOLERANCE) ? degenerateRun + 1 : 0;
+        iterations++;
+
+        if (leaving < 0) {
+            // Bound flip - the basis does not change
+            status[entering] = (status[entering] == AT_LOWER) ? AT_UPPER : AT_LOWER;
+            x[entering] = (status[entering] == AT_LOWER) ? columnLower(entering) : columnUpper(entering);
+            continue;
+        }
+
+        int leavingColumn = basic[leaving];
+        pivot(leaving, entering, w);
+        status[leavingColumn] = leavesAtLower ? AT_LOWER : AT_UPPER;
+        x[leavingColumn] = leavesAtLower ? columnLower(leavingColumn) : columnUpper(leavingColumn);
+
+        if (++sinceFactor >= REFACTOR_PERIOD) {
+            sinceFactor = 0;
+            if (!factorBasis())
+                return LP_ITERATION_LIMIT;
+            computeBasicValues();
+        }
+    }
+    return LP_ITERATION_LIMIT;
+}
+
+//
+// dualSimplex() - Starts from a dual feasible basis and removes the primal
+//          infeasibility one row at a time (the most infeasible row leaves).
+//
+LPStatus SparseLP::dualSimplex(int iterationLimit) {
+    int m = rowCount();
+    vector<double> y, w, rho(m);
+    int sinceFactor = 0;
+
+    while (iterations < iterationLimit) {
+
+        // Pick the leaving row
+        int    leaving = -1;
+        double worst = 1e-7;
+        double target = 0.0;
+        for (int k = 0; k < m; k++) {
+            int j = basic[k];
+            double below = columnLower(j) - x[j];
+            double above = x[j] - columnUpper(j);
+            if (below > worst) {
+                worst = below;
+                leaving = k;
+                target = columnLower(j);
+            }
+            else if (above > worst) {
+                worst = above;
+                leaving = k;
+                target = columnUpper(j);
+            }
+        }
+        if (leaving < 0)
+            return LP_OPTIMAL;          // Primal feasible (and still dual feasible)
+
+        bool increase = x[basic[leaving]] < target;    // The leaving value must go up
+        for (int c = 0; c < m; c++)
+            rho[c] = basisInverse[size_t(leaving) * m + c];
+        computeDuals(y);
+
+        // Ratio test on the row of the leaving variable
+        int    entering = -1;
+        double bestRatio = INF;
+        double bestAlpha = 0.0;
+        for (int j = 0; j < columnCount(); j++) {
+            if (status[j] == BASIC || columnLower(j) == columnUpper(j))
+                continue;
+
+            double alpha;
+            if (j < structCount()) {
+                alpha = 0.0;
+                for (const auto& e : columns[j])
+                    alpha += rho[e.row] * e.value;
+            }
+            else {
+                alpha = rho[j - structCount()];
+            }
+            if (fabs(alpha) <= TOLERANCE)
+                continue;
+
+            // x_B(leaving) moves by -alpha per unit increase of x_j
+            bool atLower = status[j] == AT_LOWER;
+            bool helps = increase ? (atLower ? alpha < 0 : alpha > 0)
+                                  : (atLower ? alpha > 0 : alpha < 0);
+            if (!helps)
+                continue;
+
+            double ratio = fabs(reducedCost(j, y)) / fabs(alpha);
+            if (ratio < bestRatio - TOLERANCE || (ratio <= bestRatio + TOLERANCE && fabs(alpha) > fabs(bestAlpha))) {
+                bestRatio = ratio;
+                bestAlpha = alpha;
+                entering = j;
+            }
+        }
+        if (entering < 0)
+            return LP_INFEASIBLE;
+
+        solveColumn(entering, w);
+        int leavingColumn = basic[leaving];
+        double delta = (x[leavingColumn] - target) / w[leaving];    // Change of the entering value
+
+        x[entering] += delta;
+        for (int k = 0; k < m; k++)
+            x[basic[k]] -= delta * w[k];
+
+        pivot(leaving, entering, w);
+        status[leavingColumn] = (target == columnLower(leavingColumn)) ? AT_LOWER : AT_UPPER;
+        x[leavingColumn] = target;
+        iterations++;
+
+        if (++sinceFactor >= REFACTOR_PERIOD) {
+            sinceFactor = 0;
+            if (!factorBasis())
+                return LP_ITERATION_LIMIT;
+            computeBasicValues();
+        }
+    }
+    return LP_ITERATION_LIMIT;
+}
+
+
+//
+// solve() - Warm starts from the basis of the last solve when possible,
+//           otherwise starts from the slack basis
+//
+LPStatus SparseLP::solve() {
+    int iterationLimit = 50 * (columnCount() + rowCount()) + 1000;
+    iterations = 0;
+    lastWarm = false;
+
+    if (haveBasis && (int)status.size() == columnCount()) {
+        // Put each nonbasic column on its (possibly changed) bound
+        for (int j = 0; j < columnCount(); j++) {
+            if (status[j] == AT_UPPER && columnUpper(j) == INF)
+                status[j] = AT_LOWER;
+            if (status[j] != BASIC)
+                x[j] = (status[j] == AT_LOWER) ? columnLower(j) : columnUpper(j);
+        }
+
+        if (factorBasis()) {
+            computeBasicValues();
+            if (isPrimalFeasible()) {
+                lastWarm = true;
+            }
+            else if (isDualFeasible() && dualSimplex(iterationLimit) == LP_OPTIMAL) {
+                lastWarm = true;
+            }
+        }
+    }
+
+    if (!lastWarm) {
+        iterations = 0;
+        coldStart();
+        if (!isPrimalFeasible()) {
+            haveBasis = false;
+            return LP_INFEASIBLE;   // The slack basis must be feasible (see SparseLP.h)
+        }
+    }
+
+    LPStatus result = primalSimplex(iterationLimit);
+
+    // Clean up the rounding of the updates before the values are used
+    if (result == LP_OPTIMAL && factorBasis())
+        computeBasicValues();
+
+    haveBasis = (result == LP_OPTIMAL);
+    return result;
+}
+
+//
+// getObjective() - c'x of the last solve
+//
+double SparseLP::getObjective() const {
+    double total = 0.0;
+    for (int j = 0; j < structCount(); j++)
+        total += cost[j] * x[j];
+    return total;
+}
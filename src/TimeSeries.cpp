@@ -0,0 +1,234 @@
+// File: TimeSeries.cpp
+//
+// Contains the function definitions for the time-stepped simulation (see
+// TimeSeries.h)
+//
+#include <iostream>
+#include <iomanip>
+#include <unordered_map>
+#include "../header/TimeSeries.h"
+#include "../header/GridFile.h"
+
+using namespace std;
+
+//
+// parseHeader() - Finds the input and the plant or area of each column.
+//                 Returns 0 on success.
+//
+int TimeSeriesSimulation::parseHeader(string_view header) {
+    // The plant type each plant input applies to
+    struct InputName {
+        string_view name;
+        SeriesInput input;
+        PlantType   type;
+    };
+    static const InputName INPUT_NAMES[] = {
+        { "sunlight", SERIES_SUNLIGHT, PlantType::Solar },
+        { "wind",     SERIES_WIND,     PlantType::Wind },
+        { "flow",     SERIES_FLOW,     PlantType::Hydro },
+        { "rods",     SERIES_RODS,     PlantType::Nuclear },
+        { "throttle", SERIES_THROTTLE, PlantType::Gas },
+    };
+
+    // Find the plants and areas by the NameID of their names
+    unordered_map<NameID, size_t> plantsByName;
+    unordered_map<NameID, size_t> areasByName;
+    const vector<PowerPlant*>& plants = grid.getPlants();
+    const vector<ServiceArea>& areas = grid.getAreas();
+    for (size_t i = plants.size(); i-- > 0; )
+        plantsByName[plants[i]->getNameID()] = i;     // The first plant with a name wins
+    for (size_t i = areas.size(); i-- > 0; )
+        areasByName[areas[i].getAreaNameID()] = i;
+
+    columns.clear();
+    TextScanner::splitField(header, ',');      // Interval label
+    while (!header.empty()) {
+        string_view heading = TextScanner::splitField(header, ',');
+        size_t colon = heading.find(':');
+        string_view inputName = heading.substr(0, colon);
+        string_view name = colon == string_view::npos ? string_view() : heading.substr(colon + 1);
+
+        NameID nameID;
+        bool found = grid.getNames().find(name, nameID);
+
+        if (inputName == "demand") {
+            auto area = found ? areasByName.find(nameID) : areasByName.end();
+            if (area == areasByName.end()) {
+                cerr << "Error: No service area for time series column: " << heading << endl;
+                return -1;
+            }
+            columns.push_back({ SERIES_DEMAND, area->second });
+            continue;
+        }
+
+        const InputName* pInput = nullptr;
+        for (const auto& input : INPUT_NAMES) {
+            if (input.name == inputName)
+                pInput = &input;
+        }
+        if (pInput == nullptr) {
+            cerr << "Error: Unknown time series input: " << heading << endl;
+            return -1;
+        }
+
+        auto plant = found ? plantsByName.find(nameID) : plantsByName.end();
+        if (plant == plantsByName.end() || plants[plant->second]->getPlantType() != pInput->type) {
+            cerr << "Error: No " << plantTypeName(pInput->type) << " plant for time series column: " << heading << endl;
+            return -1;
+        }
+        columns.push_back({ pInput->input, plant->second });
+    }
+    return 0;
+}
+
+
+//
+// applyInterval() - Sets the plant conditions and area demand of one line of
+//                   the input.  A value that is the same as the last
+//                   interval's is not set, so the plant is not rated again.
+//                   Returns false if a field is not a number.
+//
+bool TimeSeriesSimulation::applyInterval(string_view line, string_view& label) {
+    label = TextScanner::splitField(line, ',');
+
+    for (const auto& column : columns) {
+        string_view field = TextScanner::splitField(line, ',');
+        if (field.empty())
+            continue;
+
+        double value;
+        if (!TextScanner::parseDouble(field, value))
+            return false;
+
+        if (column.input == SERIES_DEMAND) {
+            if (grid.getAreas()[column.index].getPowerRequired() != value)
+                grid.setAreaDemand(column.index, value);
+            continue;
+        }
+
+        // Solar and wind keep the changing condition in the second rating input
+        const PowerPlant* pPlant = grid.getPlants()[column.index];
+        double input1, input2;
+        pPlant->getRatingInputs(input1, input2);
+        double current = column.input == SERIES_SUNLIGHT || column.input == SERIES_WIND ? input2 : input1;
+        if (current == value)
+            continue;
+
+        PowerPlant* pWritable = grid.writablePlant(column.index);
+        switch (column.input) {
+        case SERIES_SUNLIGHT:
+            static_cast<SolarFarm*>(pWritable)->setSunlightHours(value);
+            break;
+        case SERIES_WIND:
+            static_cast<WindFarm*>(pWritable)->setAvgWindSpeed(value);
+            break;
+        case SERIES_FLOW:
+            static_cast<HydroPlant*>(pWritable)->setFlowRate(value);
+            break;
+        case SERIES_RODS:
+            static_cast<NuclearPlant*>(pWritable)->setFuelRods((int)value);
+            break;
+        case SERIES_THROTTLE:
+            static_cast<GasPlant*>(pWritable)->setThrottle(value);
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+
+//
+// dispatchInterval() - Releases the power of the last interval, rates the
+//                      plants whose conditions changed, and runs the
+//                      distribution
+//
+void TimeSeriesSimulation::dispatchInterval() {
+    grid.clearDispatch();
+    grid.adjustPlantsForConditions();
+
+    grid.distributePower(60);
+    for (int pass = 0; pass < 4; pass++)
+        grid.distributePower(10);
+}
+
+
+//
+// writeResults() - Appends the totals of the interval to the results file
+//
+void TimeSeriesSimulation::writeResults(ofstream& results, string_view label) {
+    double required = grid.getTotalPowerRequired();
+    double supplied = grid.getTotalPowerSupplied();
+    double revenue = grid.getTotalRevenue();
+    double cost = grid.getTotalOperatingCost();
+
+    results << label << ','
+        << required << ','
+        << supplied << ','
+        << (required > 0.0 ? supplied / required * 100 : 100.0) << ','
+        << grid.getTotalRatedOutput() << ','
+        << revenue << ','
+        << cost << ','
+        << revenue - cost << '\n';
+}
+
+
+//
+// run() - Reads the input one interval at a time, models each interval, and
+//         writes its results.  Returns 0 on success.
+//
+int TimeSeriesSimulation::run(const string& inputFilename, const string& resultsFilename) {
+    ifstream input(inputFilename);
+    if (!input) {
+        cerr << "Error: Unable to open time series file " << inputFilename << endl;
+        return -1;
+    }
+
+    // The first line that is not a comment is the header
+    string line;
+    size_t lineNumber = 0;
+    while (getline(input, line)) {
+        lineNumber++;
+        if (!line.empty() && line[0] != '#')
+            break;
+    }
+    if (line.empty() || line[0] == '#') {
+        cerr << "Error: No header found in time series file " << inputFilename << endl;
+        return -1;
+    }
+    if (parseHeader(line) != 0)
+        return -1;
+
+    ofstream results(resultsFilename);
+    if (!results) {
+        cerr << "Error: Unable to create time series results file " << resultsFilename << endl;
+        return -1;
+    }
+    results << "interval,required_mw,supplied_mw,met_percent,rated_mw,revenue,cost,profit\n";
+    results << fixed << setprecision(2);
+
+    // The caller's setting is put back when the run ends
+    bool wasVerbose = grid.getVerbose();
+    grid.setVerbose(false);
+    intervals = 0;
+
+    // The line buffer is reused, so memory use does not grow with the file
+    while (getline(input, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#' || line == "\r")
+            continue;
+
+        string_view label;
+        if (!applyInterval(line, label)) {
+            cerr << "Error: Bad value on line " << lineNumber << " of time series file " << inputFilename << endl;
+            grid.setVerbose(wasVerbose);
+            return -1;
+        }
+        dispatchInterval();
+        writeResults(results, label);
+        intervals++;
+    }
+    grid.setVerbose(wasVerbose);
+    return 0;
+}
@@ -0,0 +1,349 @@
+// File: UnitCommitment.cpp
+//
+// Contains the function definitions for the multi-period unit commitment
+// (see UnitCommitment.h)
+//
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "../header/UnitCommitment.h"
+
+using namespace std;
+
+const double NO_SCHEDULE = numeric_limits<double>::infinity();
+
+
+//
+// buildUnits() - Makes a unit for every online gas and nuclear plant, adds
+//          up the output of the other plants, and finds the power the units
+//          must make in each period
+//
+void UnitCommitment::buildUnits(const CommitmentConfig& config, CommitmentSchedule& schedule) {
+    units.clear();
+    schedule.fixedOutput = 0.0;
+
+    const vector<PowerPlant*>& plants = grid.getPlants();
+    for (size_t i = 0; i < plants.size(); i++) {
+        const PowerPlant* pPlant = plants[i];
+        if (!pPlant->isOnline())
+            continue;
+
+        CommitUnit unit;
+        unit.slot = i;
+        unit.cost = pPlant->getOperatingCost();
+        if (pPlant->getPlantType() == PlantType::Gas) {
+            double step = config.throttleStep;
+            unit.nuclear = false;
+            unit.stepOutput = GasPlant::outputFor(pPlant->getMaxPowerOutput(), step);
+            unit.states = (int)floor(100.0 / step + 1e-9) + 1;
+            unit.ramp = (int)floor(config.gasRampPercent / step + 1e-9);
+            unit.initial = (int)lround(static_cast<const GasPlant*>(pPlant)->getThrottle() / step);
+        }
+        else if (pPlant->getPlantType() == PlantType::Nuclear) {
+            // Rods past the plant's maximum output are not scheduled
+            unit.nuclear = true;
+            unit.stepOutput = NuclearPlant::outputFor(1);
+            unit.states = min(MAX_FUEL_RODS, (int)(pPlant->getMaxPowerOutput() / unit.stepOutput)) + 1;
+            unit.ramp = config.nuclearRampRods;
+            unit.initial = static_cast<const NuclearPlant*>(pPlant)->getFuelRods();
+        }
+        else {
+            schedule.fixedOutput += pPlant->getCurrentOutput();
+            continue;
+        }
+        unit.ramp = max(0, unit.ramp);
+        unit.initial = clamp(unit.initial, 0, unit.states - 1);
+        units.push_back(unit);
+    }
+
+    meritOrder.resize(units.size());
+    for (size_t u = 0; u < units.size(); u++)
+        meritOrder[u] = u;
+    stable_sort(meritOrder.begin(), meritOrder.end(),
+        [this](size_t a, size_t b) { return units[a].cost < units[b].cost; });
+
+    // The plants make up the power lost on the lines in service as well
+    double lineCapacity = 0.0;
+    double deliveredCapacity = 0.0;
+    for (const auto& line : grid.getTransmissionLines()) {
+        double usable = line.getMaxCapacity() * line.getUsableFraction();
+        lineCapacity += usable;
+        deliveredCapacity += usable * line.getEfficiency();
+    }
+    double lossFactor = deliveredCapacity > 0.0 ? lineCapacity / deliveredCapacity : 1.0;
+
+    need.resize(periods);
+    for (size_t t = 0; t < periods; t++)
+        need[t] = max(0.0, config.demand[t] * lossFactor - schedule.fixedOutput);
+
+    penalty = config.unservedCost;
+    if (penalty <= 0.0) {
+        for (const auto& area : grid.getAreas())
+            penalty = max(penalty, area.getMWPrice());
+    }
+}
+
+
+//
+// scheduleUnit() - Finds the settings of one unit over every period with the
+//          least total stage cost (stageCost(period, output MW)), moving no
+//          more than the ramp limit from one period to the next.  The
+//          settings are written to pStates.  Returns the total stage cost.
+//
+//          The best setting to come from is the cheapest within the ramp
+//          limit, which is a sliding window minimum, so each period takes
+//          time in proportion to the number of settings.
+//
+template <typename StageCost>
+double UnitCommitment::scheduleUnit(const CommitUnit& unit, StageCost stageCost, UnitWork& work, int* pStates) const {
+    const int states = unit.states;
+    const int ramp = unit.ramp;
+    work.value.assign(states, NO_SCHEDULE);
+    work.next.resize(states);
+    work.back.resize(periods * states);
+    work.window.resize(states);
+
+    // The first period moves from the setting in the grid
+    int low = max(0, unit.initial - ramp);
+    int high = min(states - 1, unit.initial + ramp);
+    for (int s = low; s <= high; s++)
+        work.value[s] = stageCost(0, s * unit.stepOutput);
+
+    for (size_t t = 1; t < periods; t++) {
+        uint16_t* pBack = &work.back[t * states];
+        int head = 0;
+        int tail = 0;           // The window holds settings with increasing value
+        int nextIn = 0;
+        for (int s = 0; s < states; s++) {
+            for ( ; nextIn <= min(states - 1, s + ramp); nextIn++) {
+                while (tail > head && work.value[work.window[tail - 1]] >= work.value[nextIn])
+                    tail--;
+                work.window[tail++] = nextIn;
+            }
+            while (work.window[head] < s - ramp)
+                head++;
+
+            int from = work.window[head];
+            work.next[s] = work.value[from] + stageCost(t, s * unit.stepOutput);
+            pBack[s] = (uint16_t)from;
+        }
+        work.value.swap(work.next);
+    }
+
+    int best = (int)(min_element(work.value.begin(), work.value.end()) - work.value.begin());
+    double total = work.value[best];
+    for (size_t t = periods; t-- > 0; ) {
+        pStates[t] = best;
+        if (t > 0)
+            best = work.back[t * states + best];
+    }
+    return total;
+}
+
+
+//
+// scheduleCost() - Returns the operating cost of the settings plus the cost
+//          of the need they do not cover, and the output in each period
+//          (if pCommitted is not nullptr)
+//
+double UnitCommitment::scheduleCost(const vector<int>& states, vector<double>* pCommitted) const {
+    vector<double> covered(periods, 0.0);
+    double cost = 0.0;
+    for (size_t u = 0; u < units.size(); u++) {
+        const int* pStates = states.data() + u * periods;
+        for (size_t t = 0; t < periods; t++) {
+            double output = pStates[t] * units[u].stepOutput;
+            covered[t] += output;
+            cost += units[u].cost * output;
+        }
+    }
+    for (size_t t = 0; t < periods; t++)
+        cost += penalty * max(0.0, need[t] - covered[t]);
+
+    if (pCommitted != nullptr)
+        pCommitted->swap(covered);
+    return cost;
+}
+
+
+//
+// makeFeasible() - Changes the relaxed settings into a schedule for the
+//          demand.  Each unit in turn is scheduled again for the need the
+//          other units leave uncovered: the most expensive first (to drop
+//          the power no period needs), then the cheapest first (to cover
+//          what is still short).  Returns the cost of the schedule.
+//
+double UnitCommitment::makeFeasible(vector<int>& states, UnitWork& work) const {
+    vector<double> covered;
+    scheduleCost(states, &covered);
+
+    vector<double> uncovered(periods);
+    auto reschedule = [&](size_t u) {
+        const CommitUnit& unit = units[u];
+        int* pStates = states.data() + u * periods;
+        for (size_t t = 0; t < periods; t++)
+            uncovered[t] = need[t] - (covered[t] - pStates[t] * unit.stepOutput);
+
+        scheduleUnit(unit, [&](size_t t, double output) {
+            return unit.cost * output + penalty * max(0.0, uncovered[t] - output);
+        }, work, pStates);
+
+        for (size_t t = 0; t < periods; t++)
+            covered[t] = need[t] - uncovered[t] + pStates[t] * unit.stepOutput;
+    };
+
+    for (auto u = meritOrder.rbegin(); u != meritOrder.rend(); ++u)
+        reschedule(*u);
+    for (size_t u : meritOrder)
+        reschedule(u);
+
+    return scheduleCost(states, nullptr);
+}
+
+
+//
+// solve() - Makes the schedule with the least cost it can find.  The prices
+//          start at the cost of the plant that would cover each period's
+//          need in merit order, and take a subgradient step each iteration.
+//          The step shrinks when the lower bound stops rising, and the
+//          iterations stop when the schedule is within 0.01% of the bound.
+//
+CommitmentSchedule UnitCommitment::solve(const CommitmentConfig& config) {
+    CommitmentSchedule schedule;
+    auto start = chrono::steady_clock::now();
+
+    periods = config.demand.size();
+    buildUnits(config, schedule);
+    schedule.periods = periods;
+    schedule.need = need;
+
+    const size_t unitCount = units.size();
+    vector<double> price(periods, penalty);
+    vector<double> capacityBelow;       // Output of the units in merit order, up to each unit
+    double capacity = 0.0;
+    for (size_t u : meritOrder) {
+        capacity += (units[u].states - 1) * units[u].stepOutput;
+        capacityBelow.push_back(capacity);
+    }
+    for (size_t t = 0; t < periods; t++) {
+        size_t marginal = lower_bound(capacityBelow.begin(), capacityBelow.end(), need[t]) - capacityBelow.begin();
+        if (marginal < unitCount)
+            price[t] = min(penalty, units[meritOrder[marginal]].cost);
+    }
+
+    vector<int> relaxed(unitCount * periods, 0);
+    vector<int> best(relaxed);
+    vector<int> trial;
+    vector<double> unitValue(unitCount);
+    vector<double> committed(periods);
+    vector<UnitWork> work(pool.size());
+
+    double upper = scheduleCost(best, nullptr);     // Every plant at 0
+    double lower = -NO_SCHEDULE;
+    double theta = 2.0;
+    int sinceRaised = 0;
+
+    for (int iteration = 0; iteration < config.iterations && unitCount > 0 && periods > 0; iteration++) {
+        pool.parallelFor(unitCount, 8, [&](size_t u, size_t worker) {
+            const CommitUnit& unit = units[u];
+            unitValue[u] = scheduleUnit(unit, [&](size_t t, double output) {
+                return (unit.cost - price[t]) * output;
+            }, work[worker], relaxed.data() + u * periods);
+        });
+        schedule.iterations = iteration + 1;
+
+        // The relaxed cost is a lower bound on the cost of any schedule
+        double dual = 0.0;
+        for (double value : unitValue)
+            dual += value;
+        for (size_t t = 0; t < periods; t++)
+            dual += price[t] * need[t];
+        if (dual > lower + 1e-9 * fabs(dual)) {
+            lower = dual;
+            sinceRaised = 0;
+        }
+        else if (++sinceRaised >= 5) {
+            theta /= 2;
+            sinceRaised = 0;
+        }
+
+        if (iteration % 10 == 0 || iteration == config.iterations - 1) {
+            trial = relaxed;
+            double cost = makeFeasible(trial, work[0]);
+            if (cost < upper) {
+                upper = cost;
+                best.swap(trial);
+            }
+        }
+        if (upper - lower <= 1e-4 * fabs(upper))
+            break;
+
+        // Raise the price of the periods the relaxed schedules leave short
+        scheduleCost(relaxed, &committed);
+        double norm = 0.0;
+        for (size_t t = 0; t < periods; t++) {
+            committed[t] = need[t] - committed[t];
+            norm += committed[t] * committed[t];
+        }
+        if (norm <= 0.0)
+            break;
+        double step = theta * (upper - dual) / norm;
+        for (size_t t = 0; t < periods; t++)
+            price[t] = clamp(price[t] + step * committed[t], 0.0, penalty);
+    }
+
+    // The last relaxed schedules may not have been tried
+    if (unitCount > 0 && periods > 0) {
+        trial = relaxed;
+        double cost = makeFeasible(trial, work[0]);
+        if (cost < upper) {
+            upper = cost;
+            best.swap(trial);
+        }
+    }
+
+    // Copy the best schedule as throttle % and fuel rods
+    schedule.plants.resize(unitCount);
+    schedule.settings.resize(unitCount * periods);
+    for (size_t u = 0; u < unitCount; u++) {
+        const CommitUnit& unit = units[u];
+        schedule.plants[u] = unit.slot;
+        for (size_t t = 0; t < periods; t++) {
+            int s = best[u * periods + t];
+            schedule.settings[u * periods + t] = unit.nuclear ? s : min(100.0, s * config.throttleStep);
+            schedule.operatingCost += unit.cost * s * unit.stepOutput;
+        }
+    }
+    schedule.totalCost = scheduleCost(best, &schedule.committedOutput);
+    schedule.lowerBound = min(upper, max(0.0, lower));
+    schedule.unserved.resize(periods);
+    for (size_t t = 0; t < periods; t++)
+        schedule.unserved[t] = max(0.0, need[t] - schedule.committedOutput[t]);
+
+    auto stop = chrono::steady_clock::now();
+    schedule.seconds = chrono::duration<double>(stop - start).count();
+    return schedule;
+}
+
+
+//
+// applyPeriod() - Sets the throttle or fuel rods of each scheduled plant for
+//          one period.  A plant whose setting does not change is not rated
+//          again.
+//
+void UnitCommitment::applyPeriod(PowerGrid& scheduleGrid, const CommitmentSchedule& schedule, size_t period) {
+    for (size_t p = 0; p < schedule.plants.size(); p++) {
+        size_t slot = schedule.plants[p];
+        double setting = schedule.getSetting(p, period);
+        const PowerPlant* pPlant = scheduleGrid.getPlants()[slot];
+
+        if (pPlant->getPlantType() == PlantType::Gas) {
+            if (static_cast<const GasPlant*>(pPlant)->getThrottle() != setting)
+                static_cast<GasPlant*>(scheduleGrid.writablePlant(slot))->setThrottle(setting);
+        }
+        else if (static_cast<const NuclearPlant*>(pPlant)->getFuelRods() != (int)setting) {
+            static_cast<NuclearPlant*>(scheduleGrid.writablePlant(slot))->setFuelRods((int)setting);
+        }
+    }
+}
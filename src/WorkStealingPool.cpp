@@ -0,0 +1,126 @@
+// File: WorkStealingPool.cpp
+//
+// Contains the function definitions for the WorkStealingPool class (see WorkStealingPool.h)
+//
+#include <algorithm>
+#include "../header/WorkStealingPool.h"
+
+using namespace std;
+
+const size_t CHUNKS_PER_WORKER = 8;     // Chunks each worker gets when the grain is picked
+
+
+//
+// WorkStealingPool() - Starts the worker threads
+//
+WorkStealingPool::WorkStealingPool(size_t threadCount) {
+    if (threadCount == 0)
+        threadCount = max(1u, thread::hardware_concurrency());
+
+    for (size_t i = 0; i < threadCount; i++)
+        queues.push_back(make_unique<WorkerQueue>());
+    for (size_t i = 0; i < threadCount; i++)
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+
+//
+// ~WorkStealingPool() - Stops and joins the worker threads
+//
+WorkStealingPool::~WorkStealingPool() {
+    {
+        lock_guard<mutex> guard(jobLock);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (auto& worker : threads)
+        worker.join();
+}
+
+
+//
+// parallelFor() - Deals the chunks of the loop out to the workers in turn,
+//                 starts the workers, and waits for the last chunk
+//
+void WorkStealingPool::parallelFor(size_t count, size_t grain, const LoopBody& body) {
+    if (count == 0)
+        return;
+    if (grain == 0)
+        grain = max<size_t>(1, count / (threads.size() * CHUNKS_PER_WORKER));
+
+    size_t chunkCount = (count + grain - 1) / grain;
+    {
+        lock_guard<mutex> guard(jobLock);
+        chunksLeft = chunkCount;
+
+        size_t worker = 0;
+        for (size_t begin = 0; begin < count; begin += grain) {
+            WorkerQueue& queue = *queues[worker];
+            lock_guard<mutex> queueGuard(queue.lock);
+            queue.chunks.push_back({ begin, min(count, begin + grain), &body });
+            worker = (worker + 1) % queues.size();
+        }
+        generation++;
+    }
+    jobReady.notify_all();
+
+    unique_lock<mutex> guard(jobLock);
+    jobDone.wait(guard, [this] { return chunksLeft == 0; });
+}
+
+
+//
+// takeChunk() - Takes the newest chunk of the worker's own queue, or steals
+//               the oldest chunk of another worker's queue.  Returns false
+//               if every queue is empty.
+//
+bool WorkStealingPool::takeChunk(size_t worker, Chunk& chunk) {
+    {
+        WorkerQueue& own = *queues[worker];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.chunks.empty()) {
+            chunk = own.chunks.back();
+            own.chunks.pop_back();
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < queues.size(); i++) {
+        WorkerQueue& victim = *queues[(worker + i) % queues.size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.chunks.empty()) {
+            chunk = victim.chunks.front();
+            victim.chunks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//
+// workerLoop() - Waits for a loop to start, then runs chunks until none are left
+//
+void WorkStealingPool::workerLoop(size_t worker) {
+    size_t seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(jobLock);
+            jobReady.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+
+        Chunk chunk;
+        while (takeChunk(worker, chunk)) {
+            for (size_t i = chunk.begin; i < chunk.end; i++)
+                (*chunk.pBody)(i, worker);
+
+            if (chunksLeft.fetch_sub(1) == 1) {
+                lock_guard<mutex> guard(jobLock);
+                jobDone.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,132 @@
+//******************************************************
+//
+// File:  AllocationTotalsTest.cpp
+//
+// Checks that the plant, line, area, and allocation ledger totals agree
+// after an allocated plant is rated below the power allocated from it
+// (a gas plant throttled down and a nuclear plant with fewer fuel rods),
+// with and without the plant store, and after the minimum cost flow dispatch.
+//
+// Prints each check and returns 1 if any of them fails.
+//
+// Usage:   AllocationTotalsTest
+//
+
+#include <iostream>
+#include <cmath>
+#include "../header/GridDef.h"
+#include "../header/PowerGrid.h"
+
+using namespace std;
+
+const double TOLERANCE = 0.01;      // MW
+
+static int failures = 0;
+
+//
+// check() - Prints the result of one check and counts the failures
+//
+static void check(bool passed, const string& what) {
+    cout << (passed ? "PASS  " : "FAIL  ") << what << endl;
+    if (!passed)
+        failures++;
+}
+
+
+//
+// checkTotals() - Checks every plant against the ledger, and the power
+//                 delivered by the lines and received by the areas
+//
+static void checkTotals(const PowerGrid& grid, const string& label) {
+    vector<double> plantDrawn;
+    double delivered = grid.getLedgerTotals(plantDrawn);
+
+    bool plantsMatch = true;
+    bool withinOutput = true;
+    double allocatedCost = 0.0;
+    double ledgerCost = 0.0;
+    const vector<PowerPlant*>& plants = grid.getPlants();
+    for (size_t i = 0; i < plants.size(); i++) {
+        if (fabs(plants[i]->getCapacityAllocated() - plantDrawn[i]) > TOLERANCE)
+            plantsMatch = false;
+        if (plants[i]->getCapacityAllocated() > plants[i]->getCurrentOutput() + TOLERANCE)
+            withinOutput = false;
+        allocatedCost += plants[i]->getCostOfAllocatedPower();
+        ledgerCost += plantDrawn[i] * plants[i]->getOperatingCost();
+    }
+
+    double lineTotal = 0.0;
+    for (const auto& line : grid.getTransmissionLines())
+        lineTotal += line.getCapacityInUse();
+
+    check(plantsMatch, label + ": allocated power of each plant matches the ledger");
+    check(withinOutput, label + ": no plant is allocated more than its output");
+    check(fabs(allocatedCost - ledgerCost) <= TOLERANCE * 100, label + ": cost of allocated power matches the ledger");
+    check(fabs(grid.getTotalPowerSupplied() - delivered) <= TOLERANCE, label + ": power received by the areas matches the ledger");
+    check(fabs(lineTotal - delivered) <= TOLERANCE, label + ": power on the lines matches the ledger");
+}
+
+
+//
+// runCase() - Dispatches the grid of the data files (with distributePower or
+//             the minimum cost flow), lowers the output of the most allocated
+//             gas plant and the nuclear plant below what is allocated from
+//             them, rates the grid again, and checks the totals
+//
+static void runCase(bool useStore, bool useFlow) {
+    string label = useFlow ? "flow dispatch" : useStore ? "plant store" : "plant objects";
+
+    PowerGrid grid;
+    if (grid.readServceAreaData(AREA_FILENAME) != 0
+        || grid.readPlantData(PLANTS_FILENAME) != 0
+        || grid.readTransmissionLineData(TRANSLINES_FILENAME) != 0) {
+        check(false, label + ": read the grid data files");
+        return;
+    }
+    grid.setVerbose(false);
+    grid.enablePlantStore(useStore);
+    grid.adjustPlantsForConditions();
+    if (useFlow) {
+        grid.optimizeDispatch();
+    }
+    else {
+        grid.distributePower(60);
+        for (int pass = 0; pass < 4; pass++)
+            grid.distributePower(10);
+    }
+    checkTotals(grid, label + ", dispatched");
+
+    size_t gasSlot = grid.getPlants().size();
+    size_t nuclearSlot = grid.getPlants().size();
+    for (size_t i = 0; i < grid.getPlants().size(); i++) {
+        const PowerPlant* pPlant = grid.getPlants()[i];
+        if (pPlant->getPlantType() == PlantType::Gas
+            && (gasSlot == grid.getPlants().size() || pPlant->getCapacityAllocated() > grid.getPlants()[gasSlot]->getCapacityAllocated()))
+            gasSlot = i;
+        if (pPlant->getPlantType() == PlantType::Nuclear)
+            nuclearSlot = i;
+    }
+    if (gasSlot == grid.getPlants().size() || nuclearSlot == grid.getPlants().size()
+        || grid.getPlants()[gasSlot]->getCapacityAllocated() <= 0.0) {
+        check(false, label + ": find an allocated gas plant and a nuclear plant");
+        return;
+    }
+
+    // Rated at a quarter of what is allocated from them
+    GasPlant* pGas = static_cast<GasPlant*>(grid.writablePlant(gasSlot));
+    pGas->setThrottle(pGas->getCapacityAllocated() / 4 / pGas->getMaxPowerOutput() * 100);
+    NuclearPlant* pNuclear = static_cast<NuclearPlant*>(grid.writablePlant(nuclearSlot));
+    pNuclear->setFuelRods((int)(pNuclear->getCapacityAllocated() / 4 / NuclearPlant::outputFor(1)));
+    grid.adjustPlantsForConditions();
+    checkTotals(grid, label + ", derated");
+}
+
+
+int main() {
+    runCase(false, false);
+    runCase(true, false);
+    runCase(false, true);
+
+    cout << (failures == 0 ? "All checks passed" : "Some checks failed") << endl;
+    return failures == 0 ? 0 : 1;
+}
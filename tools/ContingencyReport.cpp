@@ -0,0 +1,104 @@
+//******************************************************
+//
+// File:  ContingencyReport.cpp
+//
+// Runs the N-1 contingency analysis (see ContingencyAnalysis.h) on the grid
+// of the data files: every plant and every transmission line is taken out
+// of service in turn, and the table lists the assets whose outage lowers
+// the percent of demand met the most.
+//
+// The data set can be made larger by copying every area, plant, and line
+// of the data files a number of times, to time the analysis on a large grid.
+//
+// Usage:   ContingencyReport [copies [threads [rows]]]
+//
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <variant>
+#include "../header/GridDef.h"
+#include "../header/PowerGrid.h"
+#include "../header/PlantVariant.h"
+#include "../header/ContingencyAnalysis.h"
+
+using namespace std;
+
+//
+// loadGrid() - Reads the data files into the grid and adds copies-1 more
+//              copies of every area, plant, and line.  The copied plants are
+//              created in the given arena.
+//
+static bool loadGrid(PowerGrid& grid, PlantArena& copyArena, size_t copies) {
+    if (grid.readServceAreaData(AREA_FILENAME) != 0
+        || grid.readPlantData(PLANTS_FILENAME) != 0
+        || grid.readTransmissionLineData(TRANSLINES_FILENAME) != 0)
+        return false;
+
+    // Copy the vectors first, the grid's vectors grow while the copies are added
+    vector<ServiceArea>      fileAreas = grid.getAreas();
+    vector<PowerPlant*>      filePlants = grid.getPlants();
+    vector<TransmissionLine> fileLines = grid.getTransmissionLines();
+
+    for (size_t copy = 1; copy < copies; copy++) {
+        for (const auto& area : fileAreas)
+            grid.addServiceArea(area.getAreaName(grid.getNames()), area.getPowerRequired(), area.getMWPrice());
+
+        for (auto pPlant : filePlants) {
+            PlantValue value = toPlantValue(*pPlant);
+            grid.addPlantToGrid(visit([&](const auto& plant) -> PowerPlant* {
+                return copyArena.create<remove_const_t<remove_reference_t<decltype(plant)>>>(plant);
+            }, value));
+        }
+
+        for (const auto& line : fileLines)
+            grid.addTransmissionLine(line.getLineID(), line.getLineName(grid.getNames()), line.getMaxCapacity(), line.getEfficiency());
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t copies = 1;
+    size_t threadCount = 0;
+    size_t rows = 20;
+    if (argc > 1)
+        copies = max<size_t>(1, strtoull(argv[1], nullptr, 10));
+    if (argc > 2)
+        threadCount = strtoull(argv[2], nullptr, 10);
+    if (argc > 3)
+        rows = strtoull(argv[3], nullptr, 10);
+
+    PlantArena copyArena;       // Declared first so it outlives the grid
+    PowerGrid grid;
+    if (!loadGrid(grid, copyArena, copies)) {
+        cerr << "Unable to read the grid data files" << endl;
+        return 1;
+    }
+    grid.setVerbose(false);
+    grid.adjustPlantsForConditions();
+
+    WorkStealingPool pool(threadCount);
+    ContingencyResults results = ContingencyAnalysis(grid, pool).run();
+
+    cout << "N-1 contingencies: " << grid.getPlants().size() << " plants, "
+        << grid.getTransmissionLines().size() << " lines" << endl;
+    cout << "Base case demand met: " << fixed << setprecision(2) << results.basePercentMet << "%" << endl << endl;
+
+    cout << "Rank   Asset   Name                    Met %      Drop\n";
+    cout << "----   -----   --------------------   --------   -------\n";
+    rows = min(rows, results.outages.size());
+    for (size_t i = 0; i < rows; i++) {
+        const ContingencyResult& outage = results.outages[i];
+        string_view name = outage.type == ASSET_PLANT ? grid.getPlants()[outage.index]->getName(grid.getNames())
+                                                      : grid.getTransmissionLines()[outage.index].getLineName(grid.getNames());
+        cout << setw(4) << right << i + 1 << "   "
+            << setw(5) << left << (outage.type == ASSET_PLANT ? "Plant" : "Line") << "   "
+            << setw(20) << left << name << "   "
+            << setw(7) << right << outage.percentMet << "%   "
+            << setw(7) << right << outage.drop << endl;
+    }
+
+    cout << endl << results.outages.size() << " outages on " << pool.size() << " thread(s) in "
+        << setprecision(3) << results.seconds << " s" << endl;
+    return 0;
+}
@@ -0,0 +1,176 @@
+//
+// File:  DispatchCompare.cpp
+//
+// Compares first fit dispatch (plants drawn on in file order, the original
+// algorithm) with merit order dispatch (the cheapest plant with enough
+// capacity is always drawn on first), with the areas served in file order
+// or by price priority (highest MW price first), and with requests that no
+// single plant and line can carry split across several of them.  The
+// minimum cost flow dispatch (see FlowDispatch.cpp) and the profit
+// maximizing LP dispatch (see LPDispatch.cpp) are run for comparison.
+//
+// The grid is read from the data files once and the plants are rated for
+// their conditions.  That state is saved, and each mode starts from it (see
+// restoreBaseline) and runs the same distribution as main() (60% then 10%
+// four times).  The table shows the power delivered, the
+// revenue, the operating cost, the profit, and the time used by the
+// distribution.
+//
+// The data set can be made larger by copying every area, plant, and line
+// of the data files a number of times, to compare the modes on a large grid.
+//
+// Usage:   DispatchCompare [copies]
+//
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <variant>
+#include "../header/GridDef.h"
+#include "../header/PowerGrid.h"
+#include "../header/PlantVariant.h"
+
+using namespace std;
+
+// How the plants are dispatched to the areas
+enum DispatchEngine { GREEDY, FLOW_DELIVERY, FLOW_PROFIT, LP_PROFIT };
+
+// Result of one distribution run
+struct DispatchResult {
+    double supplied = 0.0;      // MW delivered to the areas
+    double required = 0.0;      // MW required by the areas
+    double revenue = 0.0;
+    double cost = 0.0;
+    double milliseconds = 0.0;  // Time used by the distribution
+};
+
+//
+// loadGrid() - Reads the data files into the grid and adds copies-1 more
+//              copies of every area, plant, and line.  The copied plants are
+//              created in the given arena.
+//
+static bool loadGrid(PowerGrid& grid, PlantArena& copyArena, size_t copies) {
+    if (grid.readServceAreaData(AREA_FILENAME) != 0
+        || grid.readPlantData(PLANTS_FILENAME) != 0
+        || grid.readTransmissionLineData(TRANSLINES_FILENAME) != 0)
+        return false;
+
+    // Copy the vectors first, the grid's vectors grow while the copies are added
+    vector<ServiceArea>      fileAreas = grid.getAreas();
+    vector<PowerPlant*>      filePlants = grid.getPlants();
+    vector<TransmissionLine> fileLines = grid.getTransmissionLines();
+
+    for (size_t copy = 1; copy < copies; copy++) {
+        for (const auto& area : fileAreas)
+            grid.addServiceArea(area.getAreaName(grid.getNames()), area.getPowerRequired(), area.getMWPrice());
+
+        for (auto pPlant : filePlants) {
+            PlantValue value = toPlantValue(*pPlant);
+            grid.addPlantToGrid(visit([&](const auto& plant) -> PowerPlant* {
+                return copyArena.create<remove_const_t<remove_reference_t<decltype(plant)>>>(plant);
+            }, value));
+        }
+
+        for (const auto& line : fileLines)
+            grid.addTransmissionLine(line.getLineID(), line.getLineName(grid.getNames()), line.getMaxCapacity(), line.getEfficiency());
+    }
+    return true;
+}
+
+//
+// runDispatch() - Restores the grid to its saved state and runs the
+//                 distribution with one plant selection, area schedule, and
+//                 split setting (or runs the minimum cost flow or the LP
+//                 dispatch)
+//
+static bool runDispatch(PowerGrid& grid, DispatchEngine engine, PlantSelection mode, AreaSchedule schedule, bool split,
+                        DispatchResult& result) {
+    if (!grid.restoreBaseline())
+        return false;
+
+    grid.setPlantSelection(mode);
+    grid.setAreaSchedule(schedule);
+    grid.setSplitAllocations(split);
+
+    auto start = chrono::steady_clock::now();
+    if (engine == GREEDY) {
+        grid.distributePower(60);
+        for (int pass = 0; pass < 4; pass++)
+            grid.distributePower(10);
+    }
+    else if (engine == LP_PROFIT) {
+        grid.optimizeProfit();
+    }
+    else {
+        grid.optimizeDispatch(engine == FLOW_PROFIT ? FLOW_MAX_PROFIT : FLOW_MAX_DELIVERY);
+    }
+    auto stop = chrono::steady_clock::now();
+
+    result.milliseconds = chrono::duration<double, milli>(stop - start).count();
+    result.supplied = grid.getTotalPowerSupplied();
+    result.required = grid.getTotalPowerRequired();
+    result.revenue = grid.getTotalRevenue();
+    result.cost = grid.getTotalOperatingCost();
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t copies = 1;
+    if (argc > 1)
+        copies = max<size_t>(1, strtoull(argv[1], nullptr, 10));
+
+    struct DispatchMode {
+        string          label;
+        DispatchEngine  engine;
+        PlantSelection  plantSelection;
+        AreaSchedule    areaSchedule;
+        bool            split;
+    };
+    const DispatchMode modes[] = {
+        { "First fit",      GREEDY,         PLANT_FIRST_FIT,    AREA_FILE_ORDER,        false },
+        { "Merit order",    GREEDY,         PLANT_MERIT_ORDER,  AREA_FILE_ORDER,        false },
+        { "FF + price",     GREEDY,         PLANT_FIRST_FIT,    AREA_PRICE_PRIORITY,    false },
+        { "Merit + price",  GREEDY,         PLANT_MERIT_ORDER,  AREA_PRICE_PRIORITY,    false },
+        { "FF + split",     GREEDY,         PLANT_FIRST_FIT,    AREA_FILE_ORDER,        true },
+        { "Merit + split",  GREEDY,         PLANT_MERIT_ORDER,  AREA_FILE_ORDER,        true },
+        { "Flow (MW)",      FLOW_DELIVERY,  PLANT_FIRST_FIT,    AREA_FILE_ORDER,        false },
+        { "Flow (profit)",  FLOW_PROFIT,    PLANT_FIRST_FIT,    AREA_FILE_ORDER,        false },
+        { "LP (profit)",    LP_PROFIT,      PLANT_FIRST_FIT,    AREA_FILE_ORDER,        false },
+    };
+    const int MODE_COUNT = sizeof(modes) / sizeof(modes[0]);
+
+    PlantArena copyArena;       // Declared first so it outlives the grid
+    PowerGrid grid;
+    if (!loadGrid(grid, copyArena, copies)) {
+        cerr << "Unable to read the grid data files" << endl;
+        return 1;
+    }
+    grid.setVerbose(false);
+    grid.adjustPlantsForConditions();
+    grid.saveBaseline();
+
+    DispatchResult results[MODE_COUNT];
+    for (int i = 0; i < MODE_COUNT; i++) {
+        if (!runDispatch(grid, modes[i].engine, modes[i].plantSelection, modes[i].areaSchedule, modes[i].split, results[i]))
+            return 1;
+    }
+
+    // Lambda function to print one row of the table
+    auto printRow = [](const string& label, const DispatchResult& r) {
+        cout << setw(13) << left << label << "   "
+            << fixed << setprecision(2) << setw(12) << right << r.supplied << "   "
+            << setw(7) << right << r.supplied / r.required * 100 << "%   "
+            << setw(13) << right << r.revenue << "   "
+            << setw(13) << right << r.cost << "   "
+            << setw(13) << right << r.revenue - r.cost << "   "
+            << setprecision(3) << setw(9) << right << r.milliseconds << endl;
+    };
+
+    cout << "Data files copied " << copies << " time(s)" << endl << endl;
+    cout << "    Mode        Supplied(MW)    Met %         Revenue            Cost          Profit     Time(ms)\n";
+    cout << "-------------   ------------   --------   -------------   -------------   -------------   ---------\n";
+    for (int i = 0; i < MODE_COUNT; i++)
+        printRow(modes[i].label, results[i]);
+    return 0;
+}
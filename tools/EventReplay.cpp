@@ -0,0 +1,62 @@
+//******************************************************
+//
+// File:  EventReplay.cpp
+//
+// Runs the discrete event simulation (see EventSimulator.h) on the grid of
+// the data files: the grid is rated and dispatched as in main(), then the
+// events of the event file are run in time order.  Each event is printed
+// with the power supplied after it (unless quiet), followed by the energy
+// totals up to the given number of hours.
+//
+// Usage:   EventReplay [eventFile [hours [quiet]]]
+//
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include "../header/GridDef.h"
+#include "../header/PowerGrid.h"
+#include "../header/EventSimulator.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    string eventFilename = argc > 1 ? argv[1] : EVENTS_FILENAME;
+    double hours = argc > 2 ? atof(argv[2]) : 240.0;
+    bool quiet = argc > 3 && string(argv[3]) == "quiet";
+
+    PowerGrid grid;
+    if (grid.readServceAreaData(AREA_FILENAME) != 0
+        || grid.readPlantData(PLANTS_FILENAME) != 0
+        || grid.readTransmissionLineData(TRANSLINES_FILENAME) != 0) {
+        cerr << "Unable to read the grid data files" << endl;
+        return 1;
+    }
+    grid.setVerbose(false);
+    grid.adjustPlantsForConditions();
+    grid.distributePower(60);
+    for (int pass = 0; pass < 4; pass++)
+        grid.distributePower(10);
+
+    EventSimulator simulator(grid);
+    if (simulator.readEvents(eventFilename) != 0)
+        return 1;
+
+    cout << fixed << setprecision(2);
+    auto start = chrono::steady_clock::now();
+    if (!quiet)
+        cout << "time,event,name,value,supplied_mw,met_percent" << endl;
+    size_t count = simulator.run(hours, quiet ? nullptr : &cout);
+    auto stop = chrono::steady_clock::now();
+
+    const EventStats& stats = simulator.getStats();
+    cout << endl << count << " events over " << stats.hours << " hours in "
+        << setprecision(3) << chrono::duration<double>(stop - start).count() << " s" << endl
+        << setprecision(2)
+        << "Energy required:   " << stats.energyRequired << " MWh" << endl
+        << "Energy served:     " << stats.energyServed << " MWh ("
+        << stats.energyServed / stats.energyRequired * 100 << "%)" << endl
+        << "Lowest demand met: " << stats.lowestPercentMet << "% at hour " << stats.lowestTime << endl;
+    return 0;
+}
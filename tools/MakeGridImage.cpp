@@ -0,0 +1,51 @@
+//
+// File:  MakeGridImage.cpp
+//
+// Converter tool that reads the three text data files of the power grid
+// and writes the precompiled binary grid image loaded by initializeGrid.
+//
+// Usage:   MakeGridImage [areaFile plantFile lineFile imageFile]
+//
+// With no arguments the filenames defined in GridDef.h are used.  The image
+// must be rebuilt whenever a text data file changes (initializeGrid ignores
+// an image that is older than any of the data files).
+//
+
+#include <iostream>
+#include "../header/GridDef.h"
+#include "../header/PowerGrid.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    string areaFilename  = AREA_FILENAME;
+    string plantFilename = PLANTS_FILENAME;
+    string lineFilename  = TRANSLINES_FILENAME;
+    string imageFilename = GRID_IMAGE_FILENAME;
+
+    if (argc == 5) {
+        areaFilename  = argv[1];
+        plantFilename = argv[2];
+        lineFilename  = argv[3];
+        imageFilename = argv[4];
+    }
+    else if (argc != 1) {
+        cerr << "Usage: " << argv[0] << " [areaFile plantFile lineFile imageFile]" << endl;
+        return 1;
+    }
+
+    // Always read the text files, never an existing image
+    PowerGrid grid;
+    if (grid.readServceAreaData(areaFilename) != 0
+        || grid.readPlantData(plantFilename) != 0
+        || grid.readTransmissionLineData(lineFilename) != 0) {
+        cerr << "Unable to read the grid data files" << endl;
+        return 1;
+    }
+
+    if (grid.writeGridImage(imageFilename) != 0)
+        return 1;
+
+    cout << "Grid image written to " << imageFilename << endl;
+    return 0;
+}
@@ -0,0 +1,146 @@
+//
+// File:  PlantBenchmark.cpp
+//
+// Benchmark that compares the pointer based plants vector used by the grid
+// (vector<PowerPlant*>, each plant allocated with new and called through
+// virtual functions) with the closed set representation in PlantVariant.h
+// (vector<PlantValue>, plants stored by value and called through std::visit).
+//
+// The plants in the plant data file are copied round robin until the fleet
+// has the requested number of plants.  Two passes are timed:
+//
+//  1) Rating pass:       calculateOutput() for every plant
+//  2) Distribution pass: a series of requests, each served by the first plant
+//                        with enough available capacity (the same first fit
+//                        search used by allocatePowerToArea)
+//
+// Usage:   PlantBenchmark [plantCount [requestCount]]
+//
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include "../header/GridDef.h"
+#include "../header/PowerGrid.h"
+#include "../header/PlantVariant.h"
+
+using namespace std;
+
+// Returns the milliseconds used by a function
+template <typename Function>
+double timeMilliseconds(Function function) {
+    auto start = chrono::steady_clock::now();
+    function();
+    auto stop = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(stop - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t plantCount   = 1000000;
+    size_t requestCount = 20000;
+    const int ROUNDS    = 5;        // Each pass is timed this many times and the best is kept
+
+    if (argc > 1)
+        plantCount = strtoull(argv[1], nullptr, 10);
+    if (argc > 2)
+        requestCount = strtoull(argv[2], nullptr, 10);
+
+    PowerGrid grid;
+    if (grid.readPlantData(PLANTS_FILENAME) != 0 || grid.getPlants().empty()) {
+        cerr << "Unable to read the plant data file" << endl;
+        return 1;
+    }
+    const vector<PowerPlant*>& filePlants = grid.getPlants();
+
+    // Build both fleets from the same plants in the same order
+    vector<PowerPlant*> pointerFleet;
+    vector<PlantValue>  valueFleet;
+    pointerFleet.reserve(plantCount);
+    valueFleet.reserve(plantCount);
+
+    for (size_t i = 0; i < plantCount; i++) {
+        PlantValue value = toPlantValue(*filePlants[i % filePlants.size()]);
+        pointerFleet.push_back(visit([](const auto& p) -> PowerPlant* {
+            return new typename remove_const<remove_reference_t<decltype(p)>>::type(p);
+        }, value));
+        valueFleet.push_back(move(value));
+    }
+
+    // The requests cycle through the service area sizes so the first fit
+    // search has to walk further into the fleet as plants run out of power
+    const double requestSizes[] = { 29.6, 41.5, 8.8, 20.5, 13.5, 31.7, 7.5 };
+
+    double checkPointer = 0.0, checkValue = 0.0;
+    double ratePointer = 1e30, rateValue = 1e30;
+    double distPointer = 1e30, distValue = 1e30;
+
+    for (int round = 0; round < ROUNDS; round++) {
+
+        // Rating pass
+        ratePointer = min(ratePointer, timeMilliseconds([&]() {
+            double total = 0.0;
+            for (auto pPlant : pointerFleet)
+                total += pPlant->calculateOutput();
+            checkPointer = total;
+        }));
+
+        rateValue = min(rateValue, timeMilliseconds([&]() {
+            double total = 0.0;
+            for (auto& plant : valueFleet)
+                total += calculateOutput(plant);
+            checkValue = total;
+        }));
+
+        // Distribution pass.  Rating keeps the power allocated by the last
+        // round, so all of the capacity is given back first (not timed).
+        for (auto pPlant : pointerFleet)
+            pPlant->resetCapacity();
+        for (auto& plant : valueFleet)
+            asPlant(plant).resetCapacity();
+
+        distPointer = min(distPointer, timeMilliseconds([&]() {
+            for (size_t r = 0; r < requestCount; r++) {
+                double request = requestSizes[r % 7];
+                for (auto pPlant : pointerFleet) {
+                    if (pPlant->getAvailableCapacity() >= request) {
+                        pPlant->reduceCapacity(request);
+                        break;
+                    }
+                }
+            }
+        }));
+
+        distValue = min(distValue, timeMilliseconds([&]() {
+            for (size_t r = 0; r < requestCount; r++) {
+                double request = requestSizes[r % 7];
+                for (auto& plant : valueFleet) {
+                    PowerPlant& p = asPlant(plant);
+                    if (p.getAvailableCapacity() >= request) {
+                        p.reduceCapacity(request);
+                        break;
+                    }
+                }
+            }
+        }));
+    }
+
+    cout << "Plants: " << plantCount << "   Requests: " << requestCount
+         << "   (best of " << ROUNDS << " rounds)" << endl;
+    cout << "Bytes per plant value: " << sizeof(PlantValue)
+         << "   (pointer fleet: " << sizeof(PowerPlant*) << " byte pointer + heap object)" << endl << endl;
+    cout << "     Pass          Pointer (ms)   Variant (ms)   Speedup\n";
+    cout << "----------------   ------------   ------------   -------\n";
+    cout << fixed << setprecision(3)
+         << setw(16) << left << "Rating" << "   " << setw(12) << right << ratePointer << "   "
+         << setw(12) << right << rateValue << "   " << setw(6) << right << ratePointer / rateValue << "x" << endl
+         << setw(16) << left << "Distribution" << "   " << setw(12) << right << distPointer << "   "
+         << setw(12) << right << distValue << "   " << setw(6) << right << distPointer / distValue << "x" << endl;
+
+    if (checkPointer != checkValue)
+        cout << "Warning: the two fleets calculated different outputs" << endl;
+
+    for (auto pPlant : pointerFleet)
+        delete pPlant;
+    return 0;
+}
@@ -0,0 +1,39 @@
+//
+// File:  PlantRollup.cpp
+//
+// Tool that prints capacity totals and per type statistics for a plant
+// data file (A2_Plants.txt format) of any size.
+//
+// The file is streamed in fixed size chunks (see PlantStream.h) so the
+// plants are never all held in memory at the same time.
+//
+// Usage:   PlantRollup [plantFile [chunkBytes]]
+//
+
+#include <iostream>
+#include <cstdlib>
+#include "../header/GridDef.h"
+#include "../header/PlantStream.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    string plantFilename = PLANTS_FILENAME;
+    size_t chunkBytes = PLANT_STREAM_CHUNK_BYTES;
+
+    if (argc > 1)
+        plantFilename = argv[1];
+    if (argc > 2)
+        chunkBytes = strtoull(argv[2], nullptr, 10);
+
+    PlantStatsAggregator stats;
+    int rc = streamPlantFile(plantFilename,
+        [&](const vector<PlantEntry>& batch) { stats.addBatch(batch); },
+        chunkBytes);
+    if (rc != 0)
+        return 1;
+
+    cout << "\t--- Plant Capacity Roll-up for " << plantFilename << " ---\n";
+    stats.printReport();
+    return 0;
+}
@@ -0,0 +1,43 @@
+//******************************************************
+//
+// File:  TimeSeriesRun.cpp
+//
+// Runs the time-stepped simulation (see TimeSeries.h): the grid of the data
+// files is modeled for every interval of a time series file, and the totals
+// of each interval are written to a results file.
+//
+// Usage:   TimeSeriesRun [inputFile [resultsFile]]
+//
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include "../header/GridDef.h"
+#include "../header/PowerGrid.h"
+#include "../header/TimeSeries.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    string inputFilename = argc > 1 ? argv[1] : TIMESERIES_FILENAME;
+    string resultsFilename = argc > 2 ? argv[2] : TIMESERIES_RESULTS_FILENAME;
+
+    PowerGrid grid;
+    if (grid.readServceAreaData(AREA_FILENAME) != 0
+        || grid.readPlantData(PLANTS_FILENAME) != 0
+        || grid.readTransmissionLineData(TRANSLINES_FILENAME) != 0) {
+        cerr << "Unable to read the grid data files" << endl;
+        return 1;
+    }
+
+    TimeSeriesSimulation simulation(grid);
+    auto start = chrono::steady_clock::now();
+    if (simulation.run(inputFilename, resultsFilename) != 0)
+        return 1;
+    auto stop = chrono::steady_clock::now();
+
+    double seconds = chrono::duration<double>(stop - start).count();
+    cout << simulation.getIntervalCount() << " intervals written to " << resultsFilename
+        << " in " << fixed << setprecision(3) << seconds << " s" << endl;
+    return 0;
+}
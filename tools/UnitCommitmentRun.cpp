@@ -0,0 +1,163 @@
+//******************************************************
+//
+// File:  UnitCommitmentRun.cpp
+//
+// Schedules the gas throttles and nuclear fuel rods of the grid of the data
+// files over a number of hours (see UnitCommitment.h), then dispatches every
+// hour of the schedule with the distribution from main().
+//
+// The demand of each area follows a daily curve, from 70% of the data file
+// demand at 4 am to 100% at 4 pm.
+//
+// The data set can be made larger by copying every area, plant, and line
+// of the data files a number of times, to time the schedule on a large grid.
+//
+// Usage:   UnitCommitmentRun [hours [copies [threads]]]
+//
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <variant>
+#include "../header/GridDef.h"
+#include "../header/PowerGrid.h"
+#include "../header/PlantVariant.h"
+#include "../header/UnitCommitment.h"
+
+using namespace std;
+
+const size_t HOURS_SHOWN = 24;      // Hours of the schedule printed
+const size_t PLANTS_SHOWN = 3;      // Scheduled plants printed
+
+//
+// loadGrid() - Reads the data files into the grid and adds copies-1 more
+//              copies of every area, plant, and line.  The copied plants are
+//              created in the given arena.
+//
+static bool loadGrid(PowerGrid& grid, PlantArena& copyArena, size_t copies) {
+    if (grid.readServceAreaData(AREA_FILENAME) != 0
+        || grid.readPlantData(PLANTS_FILENAME) != 0
+        || grid.readTransmissionLineData(TRANSLINES_FILENAME) != 0)
+        return false;
+
+    // Copy the vectors first, the grid's vectors grow while the copies are added
+    vector<ServiceArea>      fileAreas = grid.getAreas();
+    vector<PowerPlant*>      filePlants = grid.getPlants();
+    vector<TransmissionLine> fileLines = grid.getTransmissionLines();
+
+    for (size_t copy = 1; copy < copies; copy++) {
+        for (const auto& area : fileAreas)
+            grid.addServiceArea(area.getAreaName(grid.getNames()), area.getPowerRequired(), area.getMWPrice());
+
+        for (auto pPlant : filePlants) {
+            PlantValue value = toPlantValue(*pPlant);
+            grid.addPlantToGrid(visit([&](const auto& plant) -> PowerPlant* {
+                return copyArena.create<remove_const_t<remove_reference_t<decltype(plant)>>>(plant);
+            }, value));
+        }
+
+        for (const auto& line : fileLines)
+            grid.addTransmissionLine(line.getLineID(), line.getLineName(grid.getNames()), line.getMaxCapacity(), line.getEfficiency());
+    }
+    return true;
+}
+
+
+//
+// demandFactor() - Returns the part of the data file demand required in an hour
+//
+static double demandFactor(size_t hour) {
+    const double PI = 3.14159265358979;
+    return 0.85 - 0.15 * cos(2 * PI * ((double)(hour % 24) - 4.0) / 24.0);
+}
+
+
+int main(int argc, char* argv[]) {
+    size_t hours = 168;
+    size_t copies = 1;
+    size_t threadCount = 0;
+    if (argc > 1)
+        hours = max<size_t>(1, strtoull(argv[1], nullptr, 10));
+    if (argc > 2)
+        copies = max<size_t>(1, strtoull(argv[2], nullptr, 10));
+    if (argc > 3)
+        threadCount = strtoull(argv[3], nullptr, 10);
+
+    PlantArena copyArena;       // Declared first so it outlives the grid
+    PowerGrid grid;
+    if (!loadGrid(grid, copyArena, copies)) {
+        cerr << "Unable to read the grid data files" << endl;
+        return 1;
+    }
+    grid.setVerbose(false);
+    grid.adjustPlantsForConditions();
+
+    vector<double> baseDemand;
+    for (const auto& area : grid.getAreas())
+        baseDemand.push_back(area.getPowerRequired());
+
+    CommitmentConfig config;
+    for (size_t hour = 0; hour < hours; hour++)
+        config.demand.push_back(grid.getTotalPowerRequired() * demandFactor(hour));
+
+    WorkStealingPool pool(threadCount);
+    CommitmentSchedule schedule = UnitCommitment(grid, pool).solve(config);
+
+    cout << "Unit commitment: " << grid.getPlants().size() << " plants ("
+        << schedule.plants.size() << " scheduled), " << hours << " hours" << endl;
+    cout << fixed << setprecision(2)
+        << "Schedule cost:    $" << schedule.totalCost << endl
+        << "Lower bound:      $" << schedule.lowerBound << " (within "
+        << (schedule.totalCost > 0.0 ? (schedule.totalCost - schedule.lowerBound) / schedule.totalCost * 100 : 0.0) << "%)" << endl
+        << "Solved in " << setprecision(3) << schedule.seconds << " s, " << schedule.iterations
+        << " iterations on " << pool.size() << " thread(s)" << endl << endl;
+
+    // Dispatch every hour with the scheduled settings
+    size_t shown = min(PLANTS_SHOWN, schedule.plants.size());
+    cout << "Hour   Demand     Need  Committed  Unserved  Supplied   Met %";
+    for (size_t p = 0; p < shown; p++)
+        cout << "  " << setw(16) << right << grid.getPlants()[schedule.plants[p]]->getName(grid.getNames());
+    cout << endl;
+
+    double energyRequired = 0.0;
+    double energyServed = 0.0;
+    double dispatchCost = 0.0;
+    for (size_t hour = 0; hour < hours; hour++) {
+        for (size_t i = 0; i < baseDemand.size(); i++)
+            grid.setAreaDemand(i, baseDemand[i] * demandFactor(hour));
+        UnitCommitment::applyPeriod(grid, schedule, hour);
+
+        grid.clearDispatch();
+        grid.adjustPlantsForConditions();
+        grid.distributePower(60);
+        for (int pass = 0; pass < 4; pass++)
+            grid.distributePower(10);
+
+        double required = grid.getTotalPowerRequired();
+        double supplied = grid.getTotalPowerSupplied();
+        energyRequired += required;
+        energyServed += supplied;
+        dispatchCost += grid.getTotalOperatingCost();
+
+        if (hour < HOURS_SHOWN) {
+            cout << setprecision(2) << setw(4) << right << hour
+                << setw(9) << right << required
+                << setw(9) << right << schedule.need[hour]
+                << setw(11) << right << schedule.committedOutput[hour]
+                << setw(10) << right << schedule.unserved[hour]
+                << setw(10) << right << supplied
+                << setw(8) << right << (required > 0.0 ? supplied / required * 100 : 100.0);
+            for (size_t p = 0; p < shown; p++)
+                cout << "  " << setw(16) << right << setprecision(0) << schedule.getSetting(p, hour);
+            cout << endl;
+        }
+    }
+
+    cout << endl << setprecision(2)
+        << "Energy required:  " << energyRequired << " MWh" << endl
+        << "Energy served:    " << energyServed << " MWh ("
+        << (energyRequired > 0.0 ? energyServed / energyRequired * 100 : 100.0) << "%)" << endl
+        << "Operating cost:   $" << dispatchCost << endl;
+    return 0;
+}
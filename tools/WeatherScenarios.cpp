@@ -0,0 +1,92 @@
+//******************************************************
+//
+// File:  WeatherScenarios.cpp
+//
+// Runs Monte Carlo weather scenarios on the grid of the data files (see
+// ScenarioEngine.h) and prints the percentiles of the unmet demand and of
+// the profit over all of the scenarios.
+//
+// The weather is drawn as factors of the data file values: sunlight and wind
+// speed vary uniformly from 40% to 120%, the river flow is normal around
+// 100% with a 25% standard deviation, and the gas throttle is uniform from
+// 60% to 100% of its setting.
+//
+// The scenarios are run once on a single thread and once on the given
+// number of threads (all cores by default) to show the speedup.  The
+// results of both runs are the same.
+//
+// Usage:   WeatherScenarios [scenarios [threads]]
+//
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include "../header/GridDef.h"
+#include "../header/PowerGrid.h"
+#include "../header/ScenarioEngine.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    ScenarioConfig config;
+    size_t threadCount = 0;
+    if (argc > 1)
+        config.scenarios = max<size_t>(1, strtoull(argv[1], nullptr, 10));
+    if (argc > 2)
+        threadCount = strtoull(argv[2], nullptr, 10);
+
+    config.sunlight = { DIST_UNIFORM, 0.4, 1.2 };
+    config.windSpeed = { DIST_UNIFORM, 0.4, 1.2 };
+    config.inflow = { DIST_NORMAL, 1.0, 0.25 };
+    config.throttle = { DIST_UNIFORM, 0.6, 1.0 };
+
+    PowerGrid grid;
+    if (grid.readServceAreaData(AREA_FILENAME) != 0
+        || grid.readPlantData(PLANTS_FILENAME) != 0
+        || grid.readTransmissionLineData(TRANSLINES_FILENAME) != 0) {
+        cerr << "Unable to read the grid data files" << endl;
+        return 1;
+    }
+    grid.setVerbose(false);
+    grid.adjustPlantsForConditions();
+
+    WorkStealingPool singlePool(1);
+    ScenarioResults single = ScenarioEngine(grid, singlePool).run(config);
+
+    WorkStealingPool pool(threadCount);
+    ScenarioResults results = ScenarioEngine(grid, pool).run(config);
+
+    if (single.unmetDemand != results.unmetDemand || single.profit != results.profit)
+        cerr << "Warning: The results depend on the number of threads" << endl;
+
+    // Lambda function to print one row of the table
+    auto printRow = [](const string& label, const ScenarioStats& s) {
+        cout << setw(14) << left << label << fixed << setprecision(2)
+            << setw(12) << right << s.mean
+            << setw(12) << right << s.minimum
+            << setw(12) << right << s.p5
+            << setw(12) << right << s.p25
+            << setw(12) << right << s.p50
+            << setw(12) << right << s.p75
+            << setw(12) << right << s.p95
+            << setw(12) << right << s.maximum << endl;
+    };
+
+    cout << config.scenarios << " weather scenarios" << endl << endl;
+    cout << "                      Mean         Min          5%         25%         50%         75%         95%         Max\n";
+    cout << "-------------   ----------  ----------  ----------  ----------  ----------  ----------  ----------  ----------\n";
+    printRow("Unmet (MW)", ScenarioResults::summarize(results.unmetDemand));
+    printRow("Profit", ScenarioResults::summarize(results.profit));
+
+    // Lambda function to print the time of one run
+    auto printTime = [&config](size_t threads, const ScenarioResults& r, double speedup) {
+        cout << setw(3) << right << threads << " thread(s):  " << fixed << setprecision(3) << r.seconds << " s   "
+            << setprecision(0) << config.scenarios / r.seconds << " scenarios/s   "
+            << setprecision(2) << speedup << "x" << endl;
+    };
+
+    cout << endl;
+    printTime(1, single, 1.0);
+    printTime(pool.size(), results, single.seconds / results.seconds);
+    return 0;
+}